@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+// Every file and folder the application uses, resolved once from
+// WolfTrackConfig and the ledger path constants under the executable's folder.
+// Building it does not touch the disk.
+struct AppPaths {
+    std::string root;            // The executable's folder
+    std::string inputPanels;
+    std::string inputArchive;
+    std::string pendingArt;
+    std::string completedArt;
+    std::string laserJobs;
+    std::string masterDir;
+    std::string masterCsv;
+    std::string masterJournal;
+    std::string masterIndex;
+    std::string panelIdReservation;
+    std::string panelStatusLog;
+    std::string pendingArtManifest;
+    std::string panelMetadataIndex;
+    std::string segmentsDir;
+    std::string metricsFile;
+    std::string settingsFile;
+};
+
+// The resolved paths, built on first use
+const AppPaths& appPaths();
+
+// Create a folder and its parents unless this process already knows it
+// exists. Only the first call for a folder reaches the filesystem, and a
+// folder whose parent is known costs a single mkdir. Thread-safe.
+bool ensureDirectory(const std::string& dir);
+
+// Forget that a folder exists, e.g. after a write into it failed because
+// someone moved it away; the next ensureDirectory() recreates it
+void forgetDirectory(const std::string& dir);
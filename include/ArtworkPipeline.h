@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.h"
+#include "MasterData.h"
+
+// One panel to generate artwork for
+struct ArtworkJob {
+    Panel panel;
+    std::string operatorName;
+};
+
+// What the pipeline produced for one panel
+struct ArtworkResult {
+    std::string panelID;
+    std::string artPath;    // *_panel_art.svg
+    std::string labelPath;  // *_datamatrix.svg
+    PanelMetadataRecord metadata{};  // panel_info.wtm; all zero if only panel_info.txt was written
+    bool ok;
+    bool alreadyLasered = false;     // Not written: the panel is Lasered and its artwork is in CompletedArt
+};
+
+// Counters for one pipeline stage, summed over its workers
+struct ArtworkStageTiming {
+    std::string stage;
+    long long items;
+    long long busyMicros;     // Time spent doing the stage's work
+    long long blockedMicros;  // Time spent waiting for room downstream (back-pressure)
+};
+
+// Generates panel artwork on a pool of worker threads. Panels flow through
+// four stages connected by bounded queues:
+//   parse  - resolve the output folder and the DataMatrix payload
+//   layout - encode the DataMatrix symbol
+//   render - build the artwork SVG, label SVG and metadata record in memory
+//   write  - create the folder and write the SVGs and panel_info files
+// submit() blocks when the pipeline is full, so a huge batch never holds more
+// than a few queues' worth of panels in memory. Uses only portable code.
+class ArtworkPipeline {
+public:
+    // outputRoot is the PendingArt folder; workers = 0 uses one per CPU
+    explicit ArtworkPipeline(const std::string& outputRoot, unsigned int workers = 0,
+                             size_t queueCapacity = 32);
+    ~ArtworkPipeline();
+
+    ArtworkPipeline(const ArtworkPipeline&) = delete;
+    ArtworkPipeline& operator=(const ArtworkPipeline&) = delete;
+
+    // Queue a panel; waits while the pipeline is full
+    void submit(ArtworkJob job);
+
+    // Stop accepting work, wait for everything queued and return the results
+    // in submission order
+    std::vector<ArtworkResult> finish();
+
+    // Per-stage counters so far
+    std::vector<ArtworkStageTiming> timings() const;
+
+    // Run all four stages for one panel on the calling thread, without
+    // starting any workers
+    static ArtworkResult runInline(const std::string& outputRoot, ArtworkJob job);
+
+private:
+    struct Item;
+    // What every stage needs besides the item, fixed when the run starts
+    struct Context {
+        std::string outputRoot;
+        MasterStats stats;      // Ledger totals recorded in the panel metadata
+        long long generatedAt;  // Seconds since epoch the run started
+    };
+    struct Stage {
+        const char* name;
+        std::atomic<long long> items{0};
+        std::atomic<long long> busyMicros{0};
+        std::atomic<long long> blockedMicros{0};
+        std::atomic<int> running{0};
+    };
+    using Queue = BoundedQueue<std::unique_ptr<Item>>;
+
+    void startStage(int stage, unsigned int workers);
+    void runStage(int stage);
+    static Context makeContext(const std::string& outputRoot);
+    static void process(int stage, Item& item, SvgWriter& svg, const Context& context);
+
+    Context m_context;
+    std::vector<std::unique_ptr<Queue>> m_queues;  // Input queue of each stage
+    Stage m_stages[4];
+    std::vector<std::thread> m_threads;
+    std::mutex m_resultsMutex;
+    std::vector<std::pair<size_t, ArtworkResult>> m_results;  // Tagged with submission index
+    size_t m_submitted = 0;
+    bool m_finished = false;
+};
+
+// Generate artwork for every panel in PendingArt and return one result per panel;
+// the panels are added to the pending-work queue. Panels already Lasered are
+// skipped, since their artwork has moved on to CompletedArt.
+std::vector<ArtworkResult> generateArtworkForPanels(const std::vector<Panel>& panels,
+                                                    const std::string& operatorName,
+                                                    std::vector<ArtworkStageTiming>* timings = nullptr);
+
+// Regenerate artwork for every panel in the master journal that is not yet
+// Lasered; returns the number that failed
+int regenerateAllArtwork(std::vector<ArtworkStageTiming>* timings = nullptr);
+
+// One line per stage, e.g. "render: 120 panels, busy 35 ms, blocked 2 ms"
+std::string formatArtworkTimings(const std::vector<ArtworkStageTiming>& timings);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "LedgerWriter.h"
+#include "SerialIndex.h"
+#include "ArtworkPipeline.h"
+
+// Outcome of draining an input folder in one pass
+struct BatchImportSummary {
+    int filesFound;                       // CSV files seen in the input folder
+    int panelsImported;                   // Panels written to the master ledger
+    int filesFailed;                      // Files that could not be parsed or archived
+    std::string firstPanelID;             // First PanelID assigned in this batch
+    std::string lastPanelID;              // Last PanelID assigned in this batch
+    std::vector<std::string> failedFiles; // Paths left in the input folder for review
+    LedgerError ledgerError;              // Why the ledger append failed, if it did
+    std::vector<SerialDuplicate> duplicateSerials; // Serials already used, in the ledger or this batch
+    int artworkFailed;                    // Imported panels whose artwork could not be generated
+    std::vector<ArtworkStageTiming> artworkTimings; // Per-stage counters from the artwork pipeline
+};
+
+// Import every CSV in inputDir: parse in parallel, assign PanelIDs in arrival
+// order, append all ledger records in one write and archive the imported files.
+// Uses only portable code so it can run headless (no Win32 GUI).
+BatchImportSummary runBatchImport(const std::string& inputDir);
+
+// Human-readable, multi-line summary of a batch run
+std::string formatBatchImportSummary(const BatchImportSummary& summary);
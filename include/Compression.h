@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Small LZ77 compressor for archived inputs and closed ledger segments.
+// The output starts with a "WTZ1" tag and the uncompressed size, followed by
+// LZ4-style sequences (literal run, then a back-reference of 4+ bytes within
+// the previous 64 KB). CSV and journal data typically shrink 3-10x.
+std::string compressBytes(std::string_view input);
+
+// Reverse compressBytes(). Returns false, leaving out unspecified, if the data
+// is truncated, corrupt or was not produced by compressBytes().
+bool decompressBytes(std::string_view compressed, std::string& out);
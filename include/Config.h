@@ -6,4 +6,37 @@ namespace WolfTrackConfig {
     const std::string INPUT_PANELS_ARCHIVE    = "InputPanelsArchive";
     const std::string PENDING_ART_ROOT        = "PendingArt";
     const std::string COMPLETED_ART_ROOT      = "CompletedArt";
+    const std::string LASER_JOBS_ROOT         = "LaserJobs";
+
+    // Refuse imports whose PCB serials were already lasered on an earlier panel.
+    // When false the panel is imported and the duplicates are only reported.
+    const bool REJECT_DUPLICATE_SERIALS       = true;
+
+    // Encode the 24 PCB serials in the DataMatrix label as well as the PanelID
+    const bool DATAMATRIX_INCLUDE_SERIALS     = false;
+
+    // Headless batch import also generates artwork for every imported panel
+    const bool BATCH_IMPORT_GENERATES_ART     = true;
+
+    // Load CSVs the MES drops into InputPanels without waiting for the operator.
+    // A file is picked up once its size has held still for WATCH_SETTLE_MS.
+    const bool WATCH_INPUT_PANELS             = true;
+    const int  WATCH_SETTLE_MS                = 300;
+
+    // Stage latencies (p50/p99, counts, errors) are rewritten to this file,
+    // under the executable's folder, every METRICS_DUMP_SECONDS and on exit
+    const std::string METRICS_FILE            = "MasterData\\wolftrack_metrics.txt";
+    const int  METRICS_DUMP_SECONDS           = 60;
+
+    // PanelIDs each station reserves at a time from the shared reservation
+    // file. Larger blocks touch the file less; IDs a station reserved but did
+    // not use before it closed are skipped, not reused.
+    const int  PANEL_ID_BLOCK_SIZE            = 32;
+
+    // Laser bed that combined jobs are nested onto, in the SVG units of the
+    // panel artwork (800 x 550 per panel, DataMatrix label beside it)
+    const int  LASER_BED_WIDTH                = 2200;
+    const int  LASER_BED_HEIGHT               = 1800;
+    const int  LASER_BED_MARGIN               = 10;
+    const int  LASER_JOB_SPACING              = 20;
 }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Name of the manifest kept in the root of a content archive
+const std::string ARCHIVE_MANIFEST_NAME = "manifest.tsv";
+
+// One archiving of an input file, as recorded in the manifest
+struct ArchiveEntry {
+    std::string archivedAt;     // "YYYY-MM-DD HH:MM:SS" local time
+    std::string hash;           // SHA-256 of the original bytes
+    unsigned long long size;    // Original size in bytes
+    std::string originalName;   // File name the input had when it was archived
+};
+
+// Content-addressed archive: each distinct file is stored once, compressed, as
+// objects/<first two hex digits>/<sha256>.wtz, and every archiving appends a
+// line to the manifest. Archiving a file whose contents are already stored only
+// adds the manifest line.
+
+// Archive sourcePath into archiveDir; fills entry if given. False on any error.
+bool archiveFileByContent(const std::string& archiveDir, const std::string& sourcePath,
+                          ArchiveEntry* entry = nullptr);
+
+// Read every manifest line, oldest first. A missing manifest is an empty archive.
+bool readArchiveManifest(const std::string& archiveDir, std::vector<ArchiveEntry>& entries);
+
+// Write the original bytes of a stored object to destPath, checking them against the hash
+bool restoreArchivedFile(const std::string& archiveDir, const std::string& hash, const std::string& destPath);
+
+// Where the object for hash lives inside archiveDir
+std::string archiveObjectPath(const std::string& archiveDir, const std::string& hash);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SvgWriter.h"
+
+// An encoded ECC200 DataMatrix symbol, finder patterns included (no quiet zone)
+struct DataMatrixSymbol {
+    int size = 0;                  // Modules per side
+    std::vector<uint8_t> modules;  // size*size, row-major, 1 = dark
+
+    bool dark(int row, int col) const { return modules[row * size + col] != 0; }
+};
+
+// Encode text as the smallest square ECC200 symbol that holds it (10x10 up to
+// 144x144). Uses ASCII encodation, with digit pairs packed into one codeword.
+// Returns false if the text does not fit.
+bool encodeDataMatrix(std::string_view text, DataMatrixSymbol& out);
+
+// Codewords (data then error correction) for text in the given symbol size,
+// exposed so the encoder can be checked against published examples
+bool encodeDataMatrixCodewords(std::string_view text, int& symbolSize, std::vector<uint8_t>& codewords);
+
+// Append the symbol as one <path> whose subpaths are horizontal runs of dark
+// modules, with the top-left module corner at (x, y)
+void writeDataMatrixSvgPath(const DataMatrixSymbol& symbol, int x, int y, int moduleSize, SvgWriter& svg);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Which change-notification mechanism a FolderWatcher uses
+enum class WatchBackendKind {
+    Auto,     // Native notifications, falling back to polling if they are unavailable
+    Native,   // FindFirstChangeNotification on Windows, inotify on Linux
+    Polling   // Rescan on a timer; works on any share
+};
+
+// Blocks until something in a directory may have changed
+class WatchBackend {
+public:
+    virtual ~WatchBackend() {}
+
+    // Wait up to timeout; true if a change was (or may have been) seen
+    virtual bool wait(std::chrono::milliseconds timeout) = 0;
+
+    virtual const char* name() const = 0;
+};
+
+// Create a backend for dir; returns nullptr only if Native was requested and is unavailable
+std::unique_ptr<WatchBackend> createWatchBackend(const std::string& dir, WatchBackendKind kind);
+
+// Watches a folder for new CSV files and reports each one once it has been
+// fully written: its size and timestamp have held still for settleTime and,
+// on Windows, the writer has closed it. Files already in the folder when the
+// watcher starts are left alone. Callbacks run on the watcher's own thread.
+class FolderWatcher {
+public:
+    FolderWatcher(const std::string& dir, std::function<void(const std::string&)> onFileReady,
+                  WatchBackendKind kind = WatchBackendKind::Auto,
+                  std::chrono::milliseconds settleTime = std::chrono::milliseconds(300));
+    ~FolderWatcher();
+
+    FolderWatcher(const FolderWatcher&) = delete;
+    FolderWatcher& operator=(const FolderWatcher&) = delete;
+
+    void stop();
+
+    // Name of the backend in use, e.g. "inotify" or "polling"
+    const char* backendName() const { return m_backend->name(); }
+
+private:
+    void run();
+
+    std::string m_dir;
+    std::function<void(const std::string&)> m_onFileReady;
+    std::chrono::milliseconds m_settleTime;
+    std::unique_ptr<WatchBackend> m_backend;
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+};
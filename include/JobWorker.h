@@ -0,0 +1,38 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Runs jobs one at a time on a background thread, in the order they were
+// posted. The GUI uses it to keep disk and network I/O off the message loop;
+// jobs report back by posting window messages. Portable, so it runs on Linux.
+class JobWorker {
+public:
+    JobWorker();
+    ~JobWorker();
+
+    JobWorker(const JobWorker&) = delete;
+    JobWorker& operator=(const JobWorker&) = delete;
+
+    // Queue a job; ignored once the worker has been stopped
+    void post(std::function<void()> job);
+
+    // True while a job is queued or running
+    bool busy() const;
+
+    // Finish the jobs already queued, then stop the thread
+    void stop();
+
+private:
+    void run();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::function<void()>> m_jobs;
+    bool m_running = false;
+    bool m_stopping = false;
+    std::thread m_thread;
+};
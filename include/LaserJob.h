@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Panel.h"
+
+// Laser bed a job is nested onto, in the SVG user units of the panel artwork
+// (one panel's artwork is PANEL_ART_WIDTH x PANEL_ART_HEIGHT)
+struct LaserBed {
+    int width;
+    int height;
+    int margin;    // Kept clear along every edge of the bed
+    int spacing;   // Gap between neighbouring items
+};
+
+// The bed described by WolfTrackConfig
+LaserBed configuredLaserBed();
+
+// Where one rectangle went: the sheet (one job file per sheet) and its
+// top-left corner. sheet is -1 if the rectangle is larger than the bed.
+struct LaserJobPlacement {
+    int sheet;
+    int x;
+    int y;
+};
+
+// Shelf nesting: rectangles are taken tallest first and laid left to right in
+// rows; a row that does not fit starts a new sheet. Returns one placement per
+// input rectangle, in input order.
+std::vector<LaserJobPlacement> nestLaserJob(const std::vector<int>& widths, const std::vector<int>& heights,
+                                            const LaserBed& bed);
+
+// What buildLaserJob() wrote
+struct LaserJobResult {
+    std::vector<std::string> jobPaths;         // One combined SVG per sheet
+    std::vector<std::string> placedPanels;     // PanelIDs in the job files
+    std::vector<std::string> skippedPanels;    // Too large for the bed, or the label could not be encoded
+};
+
+// Nest every panel's artwork with its DataMatrix label beside it onto as few
+// sheets of the bed as possible and write <jobName>_sheet<N>.svg into
+// outputDir. Each panel is one <g id="PanelID"> holding "<PanelID>-art" and
+// "<PanelID>-label" groups, so the operator can still pick out single panels
+// in LightBurn.
+LaserJobResult buildLaserJob(const std::vector<Panel>& panels, const std::string& operatorName,
+                             const LaserBed& bed, const std::string& outputDir, const std::string& jobName);
+
+// Build one job from every panel that is ReadyForLaser, into the LaserJobs folder
+LaserJobResult buildReadyForLaserJob(const std::string& operatorName);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "PanelJournal.h"
+
+// Path to the sidecar index kept next to the master journal
+const std::string MASTER_INDEX_PATH = "MasterData\\wolftrack_panels_master.idx";
+
+// Summary of the master journal up to the last validated record
+struct LedgerIndex {
+    int highWaterId;            // Highest WT-P-XXXXX number seen so far
+    long long rowCount;         // Panel records in the journal that are not also in a closed segment
+    long long pcbCount;         // Non-empty PCB serials across those records
+    long long closedRows;       // Records numbered below this live in closed segments and are not counted
+    long long lastRowOffset;    // Byte offset where the last validated record starts
+    long long validatedOffset;  // Byte offset just past the last validated record
+    unsigned long long lastRowHash; // Checksum of the last validated record, used to detect rewrites
+};
+
+// Format a PanelID number as "WT-P-XXXXX"
+std::string formatPanelId(int number);
+
+// Extract the number from a PanelID field ("WT-P-00042" or ="WT-P-00042"), or 0 if it has none
+int parsePanelIdNumber(const std::string& field);
+
+// Bring the index up to date with the journal, reading only records appended since the last call.
+// The index is rebuilt from scratch when the sidecar file is missing or no longer matches the journal.
+// closedRows is the number of records in closed segments: records an interrupted roll left in the
+// journal below it are skipped, as replay does, so segment and journal totals can simply be added.
+LedgerIndex refreshLedgerIndex(const std::string& journalPath, const std::string& indexPath,
+                               long long closedRows);
+
+// Fold records that were just appended at offset into the in-memory index, so the
+// next refresh does not have to read them back. Ignored if the index is not current.
+void noteLedgerRecordsAppended(const std::string& indexPath, long long offset,
+                               const std::vector<PanelJournalRecord>& records);
+
+// Write the in-memory index to its sidecar file if it has unsaved appends
+void checkpointLedgerIndex();
+
+// Drop the cached and saved index after the journal was rewritten (e.g. by a
+// segment roll); the next refresh rebuilds it from the journal
+void discardLedgerIndex(const std::string& indexPath);
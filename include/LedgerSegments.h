@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "PanelJournal.h"
+
+// Folder next to the master journal that holds closed, compressed segments
+const std::string LEDGER_SEGMENTS_DIR = "MasterData\\segments";
+
+// Index stored at the end of every closed segment file, after the compressed
+// records. Reading it is enough to decide whether a query needs the segment.
+struct LedgerSegmentFooter {
+    uint32_t magic;          // SEGMENT_FOOTER_MAGIC
+    uint32_t version;        // 1
+    int64_t firstRecord;     // Ledger-wide number of the segment's first record
+    int64_t rowCount;        // Records in the segment
+    int64_t pcbCount;        // Non-empty PCB serials across those records
+    int32_t minPanelId;      // Lowest and highest WT-P-XXXXX number, 0 if none
+    int32_t maxPanelId;
+    int64_t minCreatedAt;    // CreatedAt range, seconds since epoch
+    int64_t maxCreatedAt;
+    uint64_t payloadSize;    // Bytes of compressed records before the footer
+    uint32_t reserved;
+    uint32_t crc;            // CRC-32 of every byte before this field
+};
+
+static_assert(sizeof(LedgerSegmentFooter) == 72, "segment footer layout changed");
+
+const uint32_t SEGMENT_FOOTER_MAGIC = 0x31535457; // "WTS1"
+
+// A closed segment on disk
+struct LedgerSegmentInfo {
+    std::string path;
+    std::string month;       // "YYYY-MM" the records were created in
+    LedgerSegmentFooter footer;
+};
+
+// Totals across every closed segment, taken from the footers alone
+struct LedgerSegmentTotals {
+    long long rowCount;      // Also the ledger-wide number of the journal's first record
+    long long pcbCount;
+    int highWaterId;
+};
+
+// Closed segments ordered by firstRecord. Only footers are read, and the list
+// is cached until the folder changes.
+std::vector<LedgerSegmentInfo> listLedgerSegments(const std::string& segmentsDir);
+
+LedgerSegmentTotals ledgerSegmentTotals(const std::string& segmentsDir);
+
+// Decompress one closed segment. False if it is unreadable or fails its checks.
+bool readLedgerSegment(const LedgerSegmentInfo& segment, std::vector<PanelJournalRecord>& records);
+
+// Move every record created before the month of nowEpoch out of the journal
+// into one closed segment per month, then rewrite the journal with the rest.
+// Must run while nothing is appending. Safe to repeat after a crash: records
+// already in a segment are dropped from the journal rather than copied again.
+// Returns the number of records moved, or -1 if nothing could be changed.
+long long rollLedgerSegments(const std::string& journalPath, const std::string& segmentsDir, long long nowEpoch);
+
+// Replay closed segments and then the journal in order from firstRecord,
+// with ledger-wide record numbers. Segments before firstRecord are skipped
+// without being opened. Returns the number of records visited.
+long long replayLedger(const std::string& journalPath, const std::string& segmentsDir,
+                       const std::function<void(const PanelJournalRecord&, long long)>& visit,
+                       long long firstRecord = 0);
+
+// Replay only records created within [fromEpoch, toEpoch]. Closed segments
+// whose footer range misses the window are skipped without being opened.
+long long replayLedgerTimeRange(const std::string& journalPath, const std::string& segmentsDir,
+                                long long fromEpoch, long long toEpoch,
+                                const std::function<void(const PanelJournalRecord&, long long)>& visit);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PanelJournal.h"
+
+// Why a ledger append did not make it to disk
+enum class LedgerError {
+    None,
+    InvalidRecord,  // A PanelID, PanelNumber or serial is too long to store
+    OpenFailed,     // The journal could not be opened for appending
+    WriteFailed,    // The write was short or failed
+    SyncFailed,     // Data was written but could not be flushed to stable storage
+    ShuttingDown,   // The writer was stopped before the append was committed
+    NotMigrated     // The old master CSV has rows the journal cannot hold
+};
+
+// Operator-facing description of a ledger error
+std::string ledgerErrorToString(LedgerError error);
+
+// Append bytes to the end of a file (creating it) and flush them to stable storage
+LedgerError appendDurably(const std::string& path, const char* data, size_t length);
+
+// Lock file beside a journal. Every process numbers, appends, repairs or
+// rewrites the journal only while holding a lock on its first byte, so
+// stations sharing one ledger never reuse a record number or cut off each
+// other's records.
+std::string ledgerLockPath(const std::string& journalPath);
+
+// Outcome of one committed append
+struct LedgerCommit {
+    LedgerError error;
+    long long offset;                         // Byte offset of the first new record
+    std::vector<PanelJournalRecord> records;  // Records exactly as written
+};
+
+// Durable, group-committing appender for the master journal.
+// Callers block in append() until their records are fsynced. Appends that
+// arrive within one commit window share a single write and a single flush,
+// so a burst of imports costs one durable flush instead of one per panel.
+// The journal lock is held only while a group is numbered and written, so
+// stations sharing the ledger interleave whole groups.
+// New records continue the numbering of the journal's last record; when the
+// journal is empty (everything rolled into closed segments) firstSequence is
+// asked where to start.
+class LedgerWriter {
+public:
+    explicit LedgerWriter(const std::string& journalPath,
+                          std::chrono::milliseconds commitWindow = std::chrono::milliseconds(20),
+                          std::function<long long()> firstSequence = nullptr);
+    ~LedgerWriter();
+
+    LedgerWriter(const LedgerWriter&) = delete;
+    LedgerWriter& operator=(const LedgerWriter&) = delete;
+
+    // Append panels durably; returns once they are on disk or have failed
+    LedgerCommit append(const std::vector<Panel>& panels);
+
+    // Stop the commit thread after flushing anything already queued
+    void stop();
+
+private:
+    struct PendingAppend {
+        std::vector<PanelJournalRecord> records;
+        std::promise<LedgerCommit> done;
+    };
+
+    void commitLoop();
+    LedgerError writeGroup(std::vector<PanelJournalRecord>& records, long long& offset);
+
+    std::string m_journalPath;
+    std::chrono::milliseconds m_commitWindow;
+    std::function<long long()> m_firstSequence;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<PendingAppend> m_pending;
+    bool m_stopping = false;
+    bool m_needsRecovery = false;   // Only touched by the commit thread after construction
+    std::thread m_thread;
+};
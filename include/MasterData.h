@@ -1,9 +1,17 @@
 #pragma once
 
+#include <functional>
 #include <string>
+#include <vector>
 #include "Panel.h"
+#include "LedgerWriter.h"
+#include "SerialIndex.h"
+#include "PanelStatusLog.h"
+#include "PanelMetadata.h"
+#include "SvgWriter.h"
+#include "DataMatrix.h"
 
-// Path to the master CSV file
+// Path to the master CSV file, an Excel view regenerated from the journal
 const std::string MASTER_CSV_PATH = "MasterData\\wolftrack_panels_master.csv";
 
 // Statistics from master CSV
@@ -16,26 +24,185 @@ struct MasterStats {
 // Ensure the master CSV exists and has a header row
 void ensureMasterCsvExists();
 
-// Compute statistics from master CSV
+// Ensure the master journal exists, migrating rows from an older master CSV on first run.
+// False if it could not be created, e.g. because a CSV row does not fit the journal.
+bool ensureMasterJournalExists();
+
+// Regenerate the master CSV from the journal for Excel users
+bool exportMasterCsv();
+
+// Visit every panel in the master ledger, oldest first, with its current
+// status from the status log; returns how many were visited
+long long forEachMasterPanel(const std::function<void(const Panel&)>& visit);
+
+// Stream only the panels created within [fromEpoch, toEpoch]; closed monthly
+// segments outside the window are not opened. Returns the number visited.
+long long forEachMasterPanelCreatedBetween(long long fromEpoch, long long toEpoch,
+                                           const std::function<void(const Panel&)>& visit);
+
+// Compute statistics from the master ledger
 MasterStats computeMasterStats();
 
-// Generate the next sequential PanelID
+// Reserve the next PanelID for this station. IDs come from blocks reserved in
+// the shared reservation file, so no two stations or threads ever get the
+// same one. Empty if the reservation file could not be updated.
 std::string generateNextPanelID();
 
-// Append a panel as a new row in the master CSV
-void appendPanelToMaster(const Panel& p);
+// Give each imported panel a PanelID from generateNextPanelID(); the number
+// from the input CSV stays in panelNumber. Every import path goes through
+// here, so a file gets the same kind of identity however it was loaded.
+LedgerError assignPanelIds(std::vector<Panel>& panels);
+
+// Format a panel as one master CSV row, including the trailing newline
+std::string formatMasterRow(const Panel& p);
+
+// Append a panel as a new record in the master ledger; returns once it is on disk
+LedgerError appendPanelToMaster(const Panel& p);
+
+// Append several panels to the master ledger in one durable write
+LedgerError appendPanelsToMaster(const std::vector<Panel>& panels);
+
+// Store input panel CSV in the content-addressed archive, returns false if nothing was archived
+bool moveInputPanelToArchive(const std::string& sourcePath);
+
+// Parse the first panel from an input CSV file without touching the ledger or archive
+bool parsePanelCsvFile(const std::string& csvPath, Panel& outPanel);
+
+// Parse every panel row of an input CSV file, appending them to outPanels
+bool parsePanelsCsvFile(const std::string& csvPath, std::vector<Panel>& outPanels);
+
+// Steps of loadPanelFromCsvFile(), reported as each one completes
+enum class LoadStep {
+    Parsed,   // CSV rows read
+    Saved,    // Panels durably appended to the master ledger
+    Archived  // Input file stored in the archive
+};
+
+// What one loadPanelFromCsvFile() call found besides the panels themselves
+struct PanelLoadReport {
+    LedgerError ledgerError = LedgerError::None;  // Why saving failed
+    // Serials already in use; the file is rejected or only flagged depending
+    // on WolfTrackConfig::REJECT_DUPLICATE_SERIALS
+    std::vector<SerialDuplicate> duplicates;
+};
+
+// Load all panels from a CSV file into the ledger; outPanel receives the first one
+// and report says why a load failed. progress, if given, is called on the
+// loading thread after each step. Safe to call from several threads at once.
+bool loadPanelFromCsvFile(const std::string& csvPath, Panel& outPanel, PanelLoadReport& report,
+                          const std::function<void(LoadStep)>& progress = nullptr);
+
+// PCB serials in the panels that are already in the ledger or repeat within the list
+std::vector<SerialDuplicate> findDuplicateSerials(const std::vector<Panel>& panels);
+
+// How searchMasterPanels() matches the query against PanelIDs and PCB serials
+enum class PanelSearchMode {
+    Prefix,     // Field starts with the query
+    Substring   // Query appears anywhere in the field
+};
+
+// A ledger panel found by searchMasterPanels()
+struct PanelSearchResult {
+    Panel panel;
+    int slot;             // 0 if the PanelID matched, else the PCB slot 1..24
+    std::string matched;  // The PanelID or serial that matched
+};
+
+// Start loading the search index over the whole ledger in the background, so
+// the first search does not pay for it. Optional; searches load it on demand.
+void preloadMasterSearchIndex();
 
-// Move input panel CSV to archive folder
-void moveInputPanelToArchive(const std::string& sourcePath);
+// Case-insensitive search over every PanelID and PCB serial in the ledger,
+// oldest panel first within equal keys. Catches up with new appends first.
+std::vector<PanelSearchResult> searchMasterPanels(const std::string& query, PanelSearchMode mode,
+                                                  size_t maxResults = 100);
 
-// Load a panel from CSV file, process it, and return success
-bool loadPanelFromCsvFile(const std::string& csvPath, Panel& outPanel);
+// Move a panel forward in its lifecycle (LabelPrinted, ReadyForLaser, Lasered).
+// Costs one lookup and one small durable append to the status log; the
+// master journal and CSV are not rewritten. A Lasered panel's artwork folder
+// moves to CompletedArt.
+StatusChangeError setPanelStatus(const std::string& panelID, PanelStatus status);
+
+// Current lifecycle status of a panel, Detected if it never changed
+PanelStatus currentPanelStatus(const std::string& panelID);
+
+// PanelIDs currently in a status other than Detected, in PanelID order
+std::vector<std::string> panelsWithStatus(PanelStatus status);
+
+// Look up ledger panels by PanelID, with their current status. Uses the
+// in-memory serial and search indexes, so it costs no ledger scan once they
+// are loaded. PanelIDs not in the ledger are left out.
+std::vector<Panel> findMasterPanels(const std::vector<std::string>& panelIDs);
+
+// Absolute path of the PendingArt root folder
+std::string getPendingArtRoot();
 
 // Get the pending art folder path for a panel (creates if needed)
 std::string getPanelPendingFolder(const Panel& panel);
 
-// Create full panel artwork SVG for LightBurn
+// Store metadata records in the aggregated index, replacing earlier ones
+// for the same panels. The per-folder files are written separately.
+void recordPanelMetadata(const std::vector<PanelMetadataRecord>& records);
+
+// Latest metadata for one panel folder from the aggregated index
+bool findPanelMetadata(const std::string& panelID, PanelMetadataRecord& out);
+
+// Metadata of every panel folder in PendingArt and CompletedArt, in PanelID
+// order, from the aggregated index; no folder is opened
+std::vector<PanelMetadataRecord> allPanelMetadata();
+
+// Record that artwork for these panels is now waiting in PendingArt
+void notePanelArtPending(const std::vector<std::string>& panelIDs);
+
+// Panels with artwork waiting in PendingArt, in PanelID order, and how many.
+// Answered from the in-memory pending queue; no folder is listed or opened.
+std::vector<std::string> pendingArtPanels();
+size_t pendingArtCount();
+
+// Move a panel's PendingArt folder into CompletedArt with one rename and take
+// it off the pending queue. A folder already gone counts as moved.
+bool movePanelArtToCompleted(const std::string& panelID);
+
+// Move every pending panel that is already Lasered, e.g. after an earlier
+// move failed because the folder was open; returns the number moved
+int moveLaseredArtToCompleted();
+
+// Size of the full panel artwork, in SVG user units
+const int PANEL_ART_WIDTH = 800;
+const int PANEL_ART_HEIGHT = 550;
+
+// Build the full panel artwork SVG into svg without touching the disk
+void buildPanelArtSvg(const Panel& panel, const std::string& operatorName, SvgWriter& svg);
+
+// Append the artwork's elements, drawn from (0, 0), without the document
+// wrapper; used to place a panel inside a larger laser job
+void writePanelArtBody(const Panel& panel, const std::string& operatorName, SvgWriter& svg);
+
+// Contents of a panel's panel_info.txt, the text view of its metadata record
+std::string formatPanelInfo(const Panel& panel, const std::string& operatorName, const MasterStats& stats);
+
+// Create full panel artwork SVG for LightBurn; empty if that failed or the
+// panel is already Lasered, whose artwork stays in CompletedArt
 std::string createPanelArtSvg(const Panel& panel);
 
-// Create a placeholder DataMatrix SVG label
-std::string createPanelBarcodeSvgPlaceholder(const Panel& panel);
+// Text encoded in a panel's DataMatrix: the PanelID, plus ';'-separated serials
+// when WolfTrackConfig::DATAMATRIX_INCLUDE_SERIALS is set
+std::string dataMatrixPayload(const Panel& panel);
+
+// Build the DataMatrix label SVG into svg without touching the disk; false if
+// the payload is too large for the biggest symbol
+bool buildPanelDataMatrixSvg(const Panel& panel, const std::string& operatorName, SvgWriter& svg);
+
+// Build the label SVG around an already encoded symbol
+void buildDataMatrixLabelSvg(const Panel& panel, const DataMatrixSymbol& symbol,
+                             const std::string& operatorName, SvgWriter& svg);
+
+// Width and height of the label built around a symbol
+void dataMatrixLabelSize(const DataMatrixSymbol& symbol, int& width, int& height);
+
+// Append the label's elements, drawn from (0, 0), without the document wrapper
+void writeDataMatrixLabelBody(const Panel& panel, const DataMatrixSymbol& symbol,
+                              const std::string& operatorName, SvgWriter& svg);
+
+// Create the ECC200 DataMatrix SVG label for LightBurn
+std::string createPanelDataMatrixSvg(const Panel& panel);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Steps of the panel workflow that are always timed
+enum class MetricStage {
+    LoadPanelCsv,     // loadPanelFromCsvFile(), end to end
+    AppendToMaster,   // appendPanelsToMaster()
+    ArchiveInput,     // moveInputPanelToArchive()
+    ComputeStats,     // computeMasterStats()
+    PanelArtSvg,      // createPanelArtSvg()
+    DataMatrixSvg     // createPanelDataMatrixSvg()
+};
+
+const int METRIC_STAGE_COUNT = 6;
+
+// Short name used in the metrics file, e.g. "append_to_master"
+const char* metricStageName(MetricStage stage);
+
+// Add one timing to a stage's histogram. Lock-free; safe from any thread.
+void recordMetric(MetricStage stage, long long micros, bool failed);
+
+// Times one call of a stage on the monotonic clock. A span that ends without
+// ok() (an early failure return or an exception) is counted as an error.
+class MetricSpan {
+public:
+    explicit MetricSpan(MetricStage stage)
+        : m_stage(stage), m_start(std::chrono::steady_clock::now()) {}
+    ~MetricSpan() {
+        recordMetric(m_stage, std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - m_start).count(), !m_ok);
+    }
+
+    MetricSpan(const MetricSpan&) = delete;
+    MetricSpan& operator=(const MetricSpan&) = delete;
+
+    void ok() { m_ok = true; }
+
+private:
+    MetricStage m_stage;
+    std::chrono::steady_clock::time_point m_start;
+    bool m_ok = false;
+};
+
+// One stage's figures since the program started
+struct MetricSummary {
+    std::string stage;
+    long long count;
+    long long errors;
+    double p50Ms;       // Percentiles are accurate to within a quarter octave
+    double p99Ms;
+    double maxMs;
+    double totalMs;
+};
+
+std::vector<MetricSummary> metricsSnapshot();
+
+// The metrics file: a header line, then one row per stage
+std::string formatMetrics(const std::vector<MetricSummary>& summaries);
+
+// Write the current figures to path, replacing the previous dump
+bool writeMetricsFile(const std::string& path);
+
+// Rewrite the metrics file every interval on a background thread
+void startMetricsDump(const std::string& path, std::chrono::seconds interval);
+
+// Stop the dump thread and write the file one last time
+void stopMetricsDump();
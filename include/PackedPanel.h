@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Panel.h"
+#include "PanelJournal.h"
+
+// Maps repeated strings (operator names, source files) to small integer ids
+class StringInterner {
+public:
+    // Id of the text, adding it on first sight
+    uint32_t intern(std::string_view text);
+
+    // Text for an id returned by intern()
+    const std::string& lookup(uint32_t id) const { return m_strings[id]; }
+
+    size_t size() const { return m_strings.size(); }
+
+private:
+    std::deque<std::string> m_strings;  // deque so views into it stay valid as it grows
+    std::unordered_map<std::string_view, uint32_t> m_ids;
+};
+
+// Number of text fields packed per panel: PanelID, PanelNumber, then PCB1..PCB24
+const int PACKED_PANEL_FIELDS = 26;
+
+// One panel with all text moved out into the store's arena. Timestamps are
+// seconds since epoch (0 = not set), names are interned ids.
+struct PackedPanel {
+    int64_t createdAt;
+    int64_t laseredAt;
+    uint64_t arenaOffset;                    // Start of this panel's text in the arena, which may pass 4 GiB
+    uint32_t operatorId;
+    uint32_t sourceFileId;
+    uint8_t status;                          // PanelStatus
+    uint8_t fieldLengths[PACKED_PANEL_FIELDS];
+};
+
+// Compact, append-only collection of panels for bulk in-memory work (search,
+// stats, scans over the whole ledger). Every serial lives back to back in one
+// contiguous arena, so a panel costs one fixed record plus its text bytes
+// instead of 29 separately allocated strings.
+class PackedPanelStore {
+public:
+    // Add a panel; returns false if a field is longer than 255 bytes
+    bool add(const Panel& panel);
+
+    // Add a journal record without building an intermediate Panel
+    void add(const PanelJournalRecord& record);
+
+    // Expand a stored panel back into the regular Panel type
+    Panel toPanel(size_t index) const;
+
+    size_t size() const { return m_panels.size(); }
+    const PackedPanel& at(size_t index) const { return m_panels[index]; }
+
+    std::string_view panelID(size_t index) const { return field(index, 0); }
+    std::string_view panelNumber(size_t index) const { return field(index, 1); }
+    // slot is the PCB position 1..24; empty if the slot is unused
+    std::string_view serial(size_t index, int slot) const { return field(index, 1 + slot); }
+    const std::string& operatorName(size_t index) const { return m_names.lookup(m_panels[index].operatorId); }
+    const std::string& sourceFile(size_t index) const { return m_names.lookup(m_panels[index].sourceFileId); }
+
+    // Reserve room for a known number of panels and text bytes
+    void reserve(size_t panels, size_t arenaBytes);
+
+    // Bytes held by the store, excluding allocator overhead
+    size_t memoryUsed() const;
+
+private:
+    std::string_view field(size_t index, int field) const;
+    void appendField(PackedPanel& packed, int field, const char* text, size_t length);
+
+    std::vector<PackedPanel> m_panels;
+    std::vector<char> m_arena;
+    StringInterner m_names;
+};
+
+// Load every valid ledger record (closed segments, then the journal) into a
+// packed store; returns the number loaded
+long long loadPackedPanels(const std::string& journalPath, const std::string& segmentsDir,
+                           PackedPanelStore& store);
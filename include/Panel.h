@@ -18,7 +18,11 @@ struct Panel {
     std::string laseredAt;               // Timestamp when lasered
     PanelStatus status;                  // Current status
     std::string sourceFile;              // Path to original CSV
+    std::string operatorName;            // Operator who imported it (empty = current operator)
 };
 
 // Small helper to turn status into text
 std::string panelStatusToString(PanelStatus status);
+
+// Parse status text back into a PanelStatus (unknown text maps to Detected)
+PanelStatus panelStatusFromString(const std::string& text);
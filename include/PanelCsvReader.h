@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "Panel.h"
+
+// Streams panel rows out of an input CSV (PanelNumber,PCB1..PCB24 per row).
+// The file is read in one block and rows are split into string_view slices of
+// that buffer, so only the Panel handed back by next() allocates.
+class PanelCsvReader {
+public:
+    // Read the whole file and skip its header row. Returns false if it cannot be read.
+    bool open(const std::string& csvPath);
+
+    // Parse the next data row into outPanel, skipping blank lines.
+    // Returns false at end of file or on a row with fewer than 25 fields.
+    bool next(Panel& outPanel);
+
+    // True if reading stopped on a malformed row rather than end of file
+    bool failed() const { return m_failed; }
+
+private:
+    std::string m_path;
+    std::string m_buffer;
+    size_t m_pos = 0;
+    bool m_failed = false;
+};
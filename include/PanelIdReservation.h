@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Shared file holding the next unreserved PanelID number. Every station
+// reserves numbers from it, so two stations never hand out the same PanelID.
+const std::string PANEL_ID_RESERVATION_PATH = "MasterData\\wolftrack_panel_ids.res";
+
+// The one record in the reservation file. Checksummed so a torn or foreign
+// file is noticed and re-seeded from the ledger instead of trusted.
+struct PanelIdReservationRecord {
+    uint32_t magic;      // PANEL_ID_RESERVATION_MAGIC
+    int32_t nextId;      // First WT-P-XXXXX number nobody has reserved
+    uint32_t reserved;
+    uint32_t crc;        // CRC-32 of every byte before this field
+};
+
+static_assert(sizeof(PanelIdReservationRecord) == 16, "reservation record layout changed");
+
+const uint32_t PANEL_ID_RESERVATION_MAGIC = 0x31525457; // "WTR1"
+
+// A run of consecutive PanelID numbers; count is 0 if nothing was reserved
+struct PanelIdRange {
+    int first;
+    int count;
+};
+
+// Reserve count consecutive numbers under a byte-range lock on the reservation
+// file: read the next free number, write it back advanced by count, flush.
+// The file is never moved below floor (e.g. the ledger high-water mark + 1),
+// which also seeds a missing or damaged file.
+PanelIdRange reservePanelIdRange(const std::string& reservationPath, int count, int floor);
+
+// Per-station PanelID source. Numbers are taken from a block reserved in bulk
+// from the shared file; threads claim them with a compare-and-swap on one
+// atomic word, and only the thread that finds the block empty goes back to
+// the file. Numbers are unique across stations and rising within one
+// station, but a block a station does not use up leaves a gap.
+class PanelIdAllocator {
+public:
+    PanelIdAllocator(const std::string& reservationPath, int blockSize, std::function<int()> floor);
+
+    PanelIdAllocator(const PanelIdAllocator&) = delete;
+    PanelIdAllocator& operator=(const PanelIdAllocator&) = delete;
+
+    // Next unique number, or 0 if the reservation file could not be updated
+    int next();
+
+private:
+    std::string m_path;
+    int m_blockSize;
+    std::function<int()> m_floor;
+    std::atomic<uint64_t> m_block{0};  // Next number in the high half, end of block in the low half
+    std::mutex m_refillMutex;
+};
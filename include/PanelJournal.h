@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Panel.h"
+
+// Path to the binary journal that is the source of truth for panel records
+const std::string MASTER_JOURNAL_PATH = "MasterData\\wolftrack_panels_master.wtj";
+
+// Fixed-size, checksummed journal record. Strings are NUL-padded; the layout is
+// little-endian and identical on every supported build (checked below).
+struct PanelJournalRecord {
+    uint32_t magic;              // JOURNAL_RECORD_MAGIC
+    uint32_t sequence;           // Record number within the whole ledger (closed segments first), from 0
+    int64_t createdAt;           // Seconds since epoch
+    int64_t laseredAt;           // Seconds since epoch, 0 if not lasered
+    uint8_t status;              // PanelStatus
+    uint8_t reserved[7];
+    char panelID[24];
+    char panelNumber[24];
+    char operatorName[48];
+    char pcbSerials[24][32];
+    char sourceFile[252];        // Longer paths keep their trailing part
+    uint32_t crc;                // CRC-32 of every byte before this field
+};
+
+static_assert(sizeof(PanelJournalRecord) == 1152, "journal record layout changed");
+
+const uint32_t JOURNAL_RECORD_MAGIC = 0x314A5457; // "WTJ1"
+
+// Build a journal record for a panel. Returns false if the PanelID, PanelNumber
+// or a serial is too long to store without truncation.
+bool panelToJournalRecord(const Panel& panel, uint32_t sequence, PanelJournalRecord& out);
+
+// Convert a journal record back into a Panel
+Panel journalRecordToPanel(const PanelJournalRecord& record);
+
+// Standard CRC-32 (IEEE 802.3), the checksum used for records and segment footers
+uint32_t journalCrc32(const void* data, size_t length);
+
+// True if the record has the right magic number and checksum
+bool isValidJournalRecord(const PanelJournalRecord& record);
+
+// Renumber a record for its final position in the journal and refresh its checksum
+void setJournalRecordSequence(PanelJournalRecord& record, uint32_t sequence);
+
+// Drop a torn tail left by an interrupted write: a trailing partial record and
+// any trailing records that fail their checksum. Returns the number of bytes
+// removed, or -1 if the journal could not be repaired.
+long long recoverJournalTail(const std::string& journalPath);
+
+// Where a successful append landed, so callers can update in-memory indexes
+struct JournalAppendResult {
+    long long offset;                         // Byte offset of the first new record
+    std::vector<PanelJournalRecord> records;  // Records exactly as written
+};
+
+// Append panels to the journal in one write. Returns false (and writes nothing) on error.
+bool appendPanelsToJournal(const std::string& journalPath, const std::vector<Panel>& panels,
+                           JournalAppendResult* result = nullptr);
+
+// Replay valid records in order from firstRecord, stopping at the first torn or
+// corrupt one. The visitor gets each record and its record number. Returns the
+// number of records visited.
+long long replayPanelJournal(const std::string& journalPath,
+                             const std::function<void(const PanelJournalRecord&, long long)>& visit,
+                             long long firstRecord = 0);
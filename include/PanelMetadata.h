@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "Panel.h"
+#include "RecordLog.h"
+
+// Aggregated metadata for every panel folder in PendingArt and CompletedArt,
+// kept beside the master journal so tools load all of it in one read
+const std::string PANEL_METADATA_INDEX_PATH = "MasterData\\wolftrack_panel_metadata.wtm";
+
+// Per-folder metadata file; panel_info.txt beside it is a text view of the same record
+const std::string PANEL_METADATA_FILE = "panel_info.wtm";
+
+// Which art root a panel's folder is in
+enum class ArtLocation : uint8_t {
+    Pending = 0,
+    Completed = 1
+};
+
+// Fixed-schema metadata for one panel folder. Little-endian, identical on
+// every supported build (checked below). Strings are NUL-padded and stored
+// whole: a panel whose text does not fit keeps a text-only panel_info.txt.
+// The first record of the aggregated index is a header whose generatedAt
+// holds the index generation, bumped on every compaction.
+struct PanelMetadataRecord {
+    uint32_t magic;                  // PANEL_METADATA_MAGIC or PANEL_METADATA_HEADER_MAGIC
+    uint32_t version;                // 1
+    int64_t createdAt;               // Seconds since epoch the panel was imported, 0 if unknown
+    int64_t generatedAt;             // Seconds since epoch the artwork was written
+    int32_t totalPanelsAtCreation;   // Ledger totals when the artwork was written
+    int32_t totalPcbsAtCreation;
+    uint8_t location;                // ArtLocation
+    uint8_t reserved[7];
+    char panelID[24];                // Same limit as the master journal
+    char createdAtText[32];          // CreatedAt exactly as the panel had it
+    char operatorName[128];
+    char sourceFile[260];
+    uint8_t reserved2[24];
+    uint32_t crc;                    // CRC-32 of every byte before this field
+};
+
+static_assert(sizeof(PanelMetadataRecord) == 512, "panel metadata layout changed");
+
+const uint32_t PANEL_METADATA_MAGIC = 0x314D5457;        // "WTM1"
+const uint32_t PANEL_METADATA_HEADER_MAGIC = 0x484D5457; // "WTMH"
+
+// The panel_info.txt layout, shared by records and panels that do not fit one
+std::string formatPanelInfoText(const std::string& panelID, const std::string& operatorName,
+                                const std::string& createdAt, int totalPanels, int totalPcbs,
+                                const std::string& sourceFile);
+
+// Metadata for a panel whose artwork is written now. False if the PanelID is
+// empty or any field is too long for the record; nothing is truncated.
+bool makePanelMetadata(const Panel& panel, const std::string& operatorName, int totalPanels,
+                       int totalPcbs, long long generatedAt, PanelMetadataRecord& out);
+
+// True if the record has the right magic number and checksum
+bool isValidPanelMetadata(const PanelMetadataRecord& record);
+
+// Move the record to another art root and refresh its checksum
+void setPanelMetadataLocation(PanelMetadataRecord& record, ArtLocation location);
+
+// The record's PanelID as a string
+std::string panelMetadataID(const PanelMetadataRecord& record);
+
+// The human-readable panel_info.txt view of a record
+std::string formatPanelMetadataText(const PanelMetadataRecord& record);
+
+// Build a record from an older, text-only panel_info.txt. False if it has no
+// PanelID or a field does not fit the record.
+bool parsePanelInfoText(const std::string& text, ArtLocation location, PanelMetadataRecord& out);
+
+// Write panel_info.wtm and its panel_info.txt view into a panel folder
+bool writePanelMetadataFiles(const std::string& folder, const PanelMetadataRecord& record);
+
+// Read a folder's panel_info.wtm, falling back to parsing panel_info.txt
+bool readPanelMetadataFiles(const std::string& folder, ArtLocation location, PanelMetadataRecord& out);
+
+// In-memory view of the aggregated index: the latest record per PanelID.
+// Updates are appended under a lock shared by every station; once
+// superseded records dominate, the file is rewritten with only the latest
+// ones. Not thread-safe; callers serialise access.
+class PanelMetadataIndex {
+public:
+    explicit PanelMetadataIndex(const std::string& indexPath);
+
+    // True once refresh() found a valid index (written by this or another station)
+    bool hasIndex() const { return m_log.exists(); }
+
+    // Fold in records appended since the last call; starts over if another
+    // station compacted the index in the meantime
+    void refresh();
+
+    bool find(const std::string& panelID, PanelMetadataRecord& out) const;
+
+    // Latest record per PanelID, in PanelID order
+    const std::map<std::string, PanelMetadataRecord>& records() const { return m_latest; }
+
+    // Append records, replacing any earlier ones for the same panels.
+    // False if the index could not be updated.
+    bool put(const std::vector<PanelMetadataRecord>& records);
+
+private:
+    void compact();
+
+    RecordLog<PanelMetadataRecord> m_log;
+    std::map<std::string, PanelMetadataRecord> m_latest;
+};
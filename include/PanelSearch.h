@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "PackedPanel.h"
+
+// One field of one stored panel that matched a search
+struct PanelSearchHit {
+    uint32_t panel;   // Index into the PackedPanelStore
+    uint8_t slot;     // 0 = PanelID, 1..24 = PCB serial slot
+};
+
+// Case-insensitive prefix and substring search over the PanelIDs and PCB
+// serials of a PackedPanelStore. Keys are kept in one sorted array (prefix
+// search is a binary search plus a scan) and every key is listed under each
+// three-character sequence it contains (substring search intersects those
+// lists, then checks the few candidates left). Panels appended after a build
+// go into a small unsorted tail that is folded in once it grows.
+class PanelSearchIndex {
+public:
+    // Index every panel in the store. The store must outlive the index.
+    void build(const PackedPanelStore& store);
+
+    // Index panels added to the store since the last build or update
+    void update(const PackedPanelStore& store);
+
+    // Fields starting with prefix, in key order
+    std::vector<PanelSearchHit> findPrefix(std::string_view prefix, size_t maxHits) const;
+
+    // Fields containing text anywhere
+    std::vector<PanelSearchHit> findSubstring(std::string_view text, size_t maxHits) const;
+
+    // Fields indexed, including the unsorted tail
+    size_t keyCount() const { return m_sorted.size() + m_recent.size(); }
+
+    // Bytes held by the index, excluding the store it points into
+    size_t memoryUsed() const;
+
+private:
+    std::string_view keyText(const PanelSearchHit& key) const;
+    void addPanelKeys(uint32_t panel, std::vector<PanelSearchHit>& keys) const;
+
+    const PackedPanelStore* m_store = nullptr;
+    size_t m_indexedPanels = 0;
+    std::vector<PanelSearchHit> m_sorted;          // Keys ordered by case-folded text
+    std::vector<uint32_t> m_trigrams;               // Distinct trigrams, ascending
+    std::vector<uint32_t> m_postingStarts;          // m_postings range per trigram, plus an end marker
+    std::vector<uint32_t> m_postings;               // Positions in m_sorted, ascending per trigram
+    std::vector<PanelSearchHit> m_recent;           // Keys added since the last build
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "Panel.h"
+#include "RecordLog.h"
+
+// Append-only log of panel status changes, kept beside the master journal.
+// The journal stays write-once; a panel's current status is its last entry here.
+const std::string PANEL_STATUS_LOG_PATH = "MasterData\\wolftrack_panel_status.wtl";
+
+// One status change. Fixed-size and checksummed like journal records.
+struct PanelStatusRecord {
+    uint32_t magic;          // STATUS_RECORD_MAGIC
+    uint8_t fromStatus;      // PanelStatus before the change
+    uint8_t toStatus;        // PanelStatus after it
+    uint8_t reserved[2];
+    int64_t changedAt;       // Seconds since epoch
+    char panelID[24];
+    char operatorName[48];
+    uint32_t reserved2;
+    uint32_t crc;            // CRC-32 of every byte before this field
+};
+
+static_assert(sizeof(PanelStatusRecord) == 96, "status record layout changed");
+
+const uint32_t STATUS_RECORD_MAGIC = 0x31545457; // "WTT1"
+
+// Why a status change was refused
+enum class StatusChangeError {
+    None,
+    UnknownPanel,        // No panel with that PanelID in the ledger
+    InvalidTransition,   // Panels only move forward: Detected, LabelPrinted, ReadyForLaser, Lasered
+    WriteFailed          // The log could not be locked, repaired or appended to
+};
+
+// Operator-facing description of a status change error
+std::string statusChangeErrorToString(StatusChangeError error);
+
+// True if a panel may move from one status to another. Steps may be skipped
+// (a panel can go straight to ReadyForLaser) but never undone.
+bool isAllowedStatusTransition(PanelStatus from, PanelStatus to);
+
+// A panel's latest status change
+struct PanelStatusEntry {
+    PanelStatus status;
+    long long changedAt;         // Seconds since epoch
+    long long laseredAt;         // When it became Lasered, 0 if it has not
+    std::string operatorName;
+};
+
+// In-memory index over the status log: PanelID -> current status, plus the
+// PanelIDs in each status. Panels without an entry are still Detected.
+// Not thread-safe; callers serialise access.
+class PanelStatusStore {
+public:
+    explicit PanelStatusStore(const std::string& logPath);
+
+    // Fold in entries appended since the last call, by this or another station
+    void refresh();
+
+    // Current status, Detected if the panel never changed status
+    PanelStatus statusOf(const std::string& panelID) const;
+
+    // Latest change for the panel; false if it has none
+    bool find(const std::string& panelID, PanelStatusEntry& out) const;
+
+    // PanelIDs currently in a status other than Detected, in PanelID order
+    const std::set<std::string>& panelsIn(PanelStatus status) const;
+
+    // Check the transition against the latest state in the log and append it
+    // durably. The log is locked across stations for the check and the write.
+    StatusChangeError change(const std::string& panelID, PanelStatus to,
+                             const std::string& operatorName, long long atEpoch);
+
+private:
+    void apply(const PanelStatusRecord& record);
+
+    RecordLog<PanelStatusRecord> m_log;
+    std::unordered_map<std::string, PanelStatusEntry> m_current;
+    std::array<std::set<std::string>, 4> m_byStatus;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+#include "RecordLog.h"
+
+// Manifest of panels whose artwork is waiting in PendingArt, so listing or
+// counting pending work never walks the PendingArt folders
+const std::string PENDING_ART_MANIFEST_PATH = "MasterData\\wolftrack_pending_art.wtq";
+
+// One manifest entry. The first record of the file is a header whose
+// changedAt holds the manifest's generation, bumped on every compaction.
+struct PendingArtRecord {
+    uint32_t magic;          // PENDING_ART_RECORD_MAGIC
+    uint8_t op;              // PendingArtOp
+    uint8_t reserved[3];
+    int64_t changedAt;       // Seconds since epoch; the generation for the header
+    char panelID[24];
+    uint32_t reserved2;
+    uint32_t crc;            // CRC-32 of every byte before this field
+};
+
+static_assert(sizeof(PendingArtRecord) == 48, "pending art record layout changed");
+
+const uint32_t PENDING_ART_RECORD_MAGIC = 0x31515457; // "WTQ1"
+
+enum class PendingArtOp : uint8_t {
+    Header = 0,
+    Added = 1,      // Artwork generated into PendingArt
+    Removed = 2     // Folder moved to CompletedArt
+};
+
+// In-memory pending-work queue over the manifest. Changes are appended under
+// a lock shared by every station; once removed entries dominate, the
+// manifest is rewritten with only the live ones. Not thread-safe; callers
+// serialise access.
+class PendingArtQueue {
+public:
+    explicit PendingArtQueue(const std::string& manifestPath);
+
+    // True once refresh() found a valid manifest (written by this or another station)
+    bool hasManifest() const { return m_log.exists(); }
+
+    // Fold in entries appended since the last call; starts over if another
+    // station compacted the manifest in the meantime
+    void refresh();
+
+    bool contains(const std::string& panelID) const { return m_pending.count(panelID) != 0; }
+    size_t size() const { return m_pending.size(); }
+
+    // Pending PanelIDs in PanelID order
+    const std::set<std::string>& panels() const { return m_pending; }
+
+    // Record panels as pending, or as no longer pending; entries that would
+    // not change anything are not written. False if the manifest could not be
+    // updated, or without writing anything if a PanelID is 24 bytes or longer.
+    bool add(const std::vector<std::string>& panelIDs, long long atEpoch);
+    bool remove(const std::vector<std::string>& panelIDs, long long atEpoch);
+
+private:
+    bool change(PendingArtOp op, const std::vector<std::string>& panelIDs, long long atEpoch);
+    void apply(const PendingArtRecord& record);
+    void compact();
+
+    RecordLog<PendingArtRecord> m_log;
+    std::set<std::string> m_pending;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// The few operating-system services the import, ledger and artwork code needs,
+// with a Win32 and a POSIX implementation. Nothing outside Platform.cpp and
+// the GUI includes <windows.h>.
+
+// Full path of the running executable, and the folder holding it. The
+// application keeps all of its data beside the executable.
+std::string executablePath();
+std::string executableDirectory();
+
+// A path written with Windows separators, as the config constants are
+// ("MasterData\\file.csv"), converted to this system's separators
+std::string nativePath(const std::string& path);
+
+// relativePath under the executable's folder, e.g. appDataPath(MASTER_CSV_PATH)
+std::string appDataPath(const std::string& relativePath);
+
+// Set or clear the read-only attribute (Windows) or the write permission bits (POSIX)
+void setFileReadOnly(const std::string& path, bool readOnly);
+
+// Why a durable append failed
+enum class FileWriteError {
+    None,
+    OpenFailed,
+    WriteFailed,
+    SyncFailed      // Written, but the flush to stable storage failed
+};
+
+// Append bytes to the end of a file (creating it) and flush them to stable
+// storage before returning: FlushFileBuffers on Windows, fsync elsewhere
+FileWriteError appendFileDurably(const std::string& path, const char* data, size_t length);
+
+// True while another process still has the file open for writing. Windows
+// refuses an exclusive open until the writer closes it; POSIX has no such
+// lock, so there it is always false.
+bool isFileOpenByWriter(const std::string& path);
+
+// Exclusive advisory lock on a byte range of a file, shared between processes
+// and stations on the same share: LockFileEx on Windows, open-file-description
+// fcntl locks on Linux (plain fcntl locks elsewhere). The file is created if
+// missing. The constructor blocks until the range is free; the destructor
+// releases it. Reads and writes go through the locked handle, so closing some
+// other handle to the file never drops the lock.
+class FileRangeLock {
+public:
+    FileRangeLock(const std::string& path, unsigned long long offset, unsigned long long length);
+    ~FileRangeLock();
+
+    FileRangeLock(const FileRangeLock&) = delete;
+    FileRangeLock& operator=(const FileRangeLock&) = delete;
+
+    // False if the file could not be opened or locked
+    bool locked() const;
+
+    // Read length bytes at offset; false if the file is shorter
+    bool read(unsigned long long offset, void* data, size_t length);
+
+    // Overwrite length bytes at offset and flush them to stable storage
+    FileWriteError write(unsigned long long offset, const void* data, size_t length);
+
+private:
+    void* m_handle = nullptr;  // File handle (Windows)
+    int m_fd = -1;             // File descriptor (POSIX)
+    unsigned long long m_offset;
+    unsigned long long m_length;
+    bool m_locked = false;
+};
+
+// Blocks until something in one folder changes: FindFirstChangeNotification
+// on Windows, inotify on Linux. It only says that something changed; callers
+// rescan the folder to find out what.
+class DirectoryChangeNotifier {
+public:
+    explicit DirectoryChangeNotifier(const std::string& dir);
+    ~DirectoryChangeNotifier();
+
+    DirectoryChangeNotifier(const DirectoryChangeNotifier&) = delete;
+    DirectoryChangeNotifier& operator=(const DirectoryChangeNotifier&) = delete;
+
+    // False if the system cannot watch this folder (e.g. some network shares)
+    bool ok() const;
+
+    // Wait up to timeout; true if a change was seen
+    bool wait(std::chrono::milliseconds timeout);
+
+    const char* name() const;
+
+private:
+    void* m_handle = nullptr;  // Change notification handle (Windows)
+    int m_fd = -1;             // inotify instance and watch (POSIX)
+    int m_wd = -1;
+};
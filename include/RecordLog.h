@@ -0,0 +1,166 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Platform.h"
+
+// How a RecordLog tells its records apart. A log with a header starts with a
+// record holding its generation, bumped by every compaction, so a station
+// that sees a new generation knows to fold the file in again from the start.
+template <typename Record>
+struct RecordLogFormat {
+    bool (*isValid)(const Record& record);                           // Magic number and checksum
+    bool (*readHeader)(const Record& record, long long& generation); // Null for a log without a header
+    Record (*makeHeader)(long long generation);
+};
+
+// Append-only file of fixed-size, checksummed records shared by every
+// station. Appends are made under a lock on <path>.lck; refresh() folds in
+// only the records added since the last call. A record torn by a crash ends
+// the readable part and is cut off by the next append. Not thread-safe;
+// the owner serialises access.
+template <typename Record>
+class RecordLog {
+public:
+    using Fold = std::function<void(const Record&)>;
+
+    // fold sees every record read or appended, in file order. reset is called
+    // when a compaction replaced the file and everything folded so far is stale.
+    RecordLog(const std::string& path, const RecordLogFormat<Record>& format, Fold fold,
+              std::function<void()> reset = nullptr)
+        : m_path(path), m_format(format), m_fold(std::move(fold)), m_reset(std::move(reset)) {}
+
+    // Lock file held across stations for a check-then-append or a compaction
+    std::string lockPath() const { return m_path + ".lck"; }
+
+    // True once refresh() found a valid header; a log without one always exists
+    bool exists() const { return m_format.readHeader == nullptr || m_generation >= 0; }
+
+    // Records folded in, superseded or not, header excluded
+    long long records() const { return m_records; }
+
+    // Fold in records appended since the last call, by this or another station
+    void refresh() {
+        std::ifstream in(m_path, std::ios::in | std::ios::binary);
+        if (!in.is_open()) {
+            return;
+        }
+        if (m_format.readHeader != nullptr) {
+            Record header;
+            long long generation = 0;
+            if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+                !m_format.readHeader(header, generation)) {
+                return;
+            }
+            // A compaction replaced the file; what was folded in no longer lines up
+            if (generation != m_generation) {
+                if (m_reset) {
+                    m_reset();
+                }
+                m_records = 0;
+                m_generation = generation;
+                m_offset = static_cast<long long>(sizeof(Record));
+            }
+        }
+
+        in.seekg(static_cast<std::streamoff>(m_offset));
+        std::vector<Record> block(REFRESH_BLOCK_RECORDS);
+        while (in) {
+            in.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size() * sizeof(Record)));
+            size_t whole = static_cast<size_t>(in.gcount()) / sizeof(Record);
+            for (size_t i = 0; i < whole; ++i) {
+                // A torn record is the end for now; the next append() cuts it off
+                if (!m_format.isValid(block[i])) {
+                    return;
+                }
+                m_fold(block[i]);
+                m_records++;
+                m_offset += static_cast<long long>(sizeof(Record));
+            }
+        }
+    }
+
+    // Append records durably and fold them in. The caller holds the lock and
+    // has just called refresh(). A log with a header that has no valid file
+    // yet starts a new one, even for no records. False if nothing was written.
+    bool append(const std::vector<Record>& records) {
+        if (records.empty() && exists()) {
+            return true;
+        }
+        std::vector<Record> toWrite;
+        toWrite.reserve(records.size() + 1);
+        std::error_code ec;
+        if (!exists()) {
+            std::filesystem::remove(m_path, ec);
+            toWrite.push_back(m_format.makeHeader(0));
+        } else {
+            // Anything past the last good record was torn by a crash; drop it
+            // so the new records are not hidden behind it
+            unsigned long long size = std::filesystem::file_size(m_path, ec);
+            if (!ec && static_cast<long long>(size) > m_offset) {
+                std::filesystem::resize_file(m_path, static_cast<unsigned long long>(m_offset), ec);
+                if (ec) {
+                    return false;
+                }
+            }
+        }
+        toWrite.insert(toWrite.end(), records.begin(), records.end());
+
+        if (appendFileDurably(m_path, reinterpret_cast<const char*>(toWrite.data()),
+                              toWrite.size() * sizeof(Record)) != FileWriteError::None) {
+            return false;
+        }
+        if (!exists()) {
+            m_generation = 0;
+            m_offset = static_cast<long long>(sizeof(Record));
+        }
+        for (const Record& record : records) {
+            m_fold(record);
+            m_records++;
+            m_offset += static_cast<long long>(sizeof(Record));
+        }
+        return true;
+    }
+
+    // Rewrite the file as a new generation holding only the live records,
+    // which the owner has already folded in. The caller holds the lock; the
+    // file is left as is if the swap fails. Needs a log with a header.
+    bool compact(const std::vector<Record>& live) {
+        std::vector<Record> toWrite;
+        toWrite.reserve(live.size() + 1);
+        toWrite.push_back(m_format.makeHeader(m_generation + 1));
+        toWrite.insert(toWrite.end(), live.begin(), live.end());
+
+        std::string tmpPath = m_path + ".tmp";
+        std::error_code ec;
+        std::filesystem::remove(tmpPath, ec);
+        if (appendFileDurably(tmpPath, reinterpret_cast<const char*>(toWrite.data()),
+                              toWrite.size() * sizeof(Record)) != FileWriteError::None) {
+            return false;
+        }
+        std::filesystem::rename(tmpPath, m_path, ec);
+        if (ec) {
+            return false;
+        }
+        m_generation++;
+        m_records = static_cast<long long>(live.size());
+        m_offset = static_cast<long long>(toWrite.size() * sizeof(Record));
+        return true;
+    }
+
+private:
+    // Records read per block when catching up
+    static constexpr size_t REFRESH_BLOCK_RECORDS = 256;
+
+    std::string m_path;
+    RecordLogFormat<Record> m_format;
+    Fold m_fold;
+    std::function<void()> m_reset;
+    long long m_offset = 0;       // Bytes of the file already folded in
+    long long m_generation = -1;  // Header generation folded in
+    long long m_records = 0;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Panel.h"
+#include "PanelJournal.h"
+
+// Where a PCB serial was first recorded in the ledger
+struct SerialLocation {
+    std::string panelID;
+    int slot;            // PCB position 1..24
+    long long row;       // Journal record number
+};
+
+// A serial in an incoming panel that is already in the ledger (or repeated within the panel)
+struct SerialDuplicate {
+    std::string serial;
+    int slot;                // PCB position 1..24 in the incoming panel
+    SerialLocation existing; // Where it was seen before
+};
+
+// Hash index over the ledger: PCB serial -> (PanelID, slot) and PanelID -> row.
+// Lookups are O(1) per serial, so imports never rescan the ledger.
+class SerialIndex {
+public:
+    // Add every non-empty serial of a journal record stored at the given row
+    void addRecord(const PanelJournalRecord& record, long long row);
+
+    // Add every non-empty serial of a panel that is not in the journal yet (row -1)
+    void addPanel(const Panel& panel, long long row);
+
+    // Look up where a serial was first used
+    bool findSerial(const std::string& serial, SerialLocation& out) const;
+
+    // Look up the journal row of the first record with this PanelID
+    bool findPanelRow(const std::string& panelID, long long& row) const;
+
+    // Serials in the panel that are already indexed or appear twice in it
+    std::vector<SerialDuplicate> findDuplicates(const Panel& panel) const;
+
+    // Number of distinct serials indexed
+    size_t serialCount() const { return m_serials.size(); }
+
+private:
+    std::unordered_map<std::string, SerialLocation> m_serials;
+    std::unordered_map<std::string, long long> m_panelRows;
+};
+
+// One line per duplicate, e.g. "ABC001 (slot 1) already on WT-P-00001 slot 1";
+// stops after maxLines and says how many more there were
+std::string formatDuplicateSerials(const std::vector<SerialDuplicate>& duplicates, size_t maxLines = 10);
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// SHA-256 of data as 64 lowercase hex digits
+std::string sha256Hex(std::string_view data);
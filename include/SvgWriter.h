@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Builds an SVG document in one growable buffer and writes it out in a single
+// call. Numbers are formatted with std::to_chars, so nothing allocates once the
+// buffer has grown to fit a document; reuse one writer across panels.
+class SvgWriter {
+public:
+    explicit SvgWriter(size_t initialCapacity = 16 * 1024);
+
+    // Start a new document, keeping the buffer's capacity
+    void clear() { m_buffer.clear(); }
+
+    // Append markup as-is
+    SvgWriter& raw(std::string_view markup);
+
+    // Append text content, escaping the characters XML reserves
+    SvgWriter& text(std::string_view content);
+
+    // Append a decimal integer
+    SvgWriter& number(long long value);
+
+    // Append a rectangle: <rect x=".." y=".." width=".." height=".." + attributes + "/>\n"
+    SvgWriter& rect(int x, int y, int width, int height, std::string_view attributes);
+
+    // Write the whole document to a file with one write; false on failure
+    bool writeToFile(const std::string& path) const;
+
+    const std::string& str() const { return m_buffer; }
+
+private:
+    std::string m_buffer;
+};
+
+// Write a whole file with one unbuffered write; false on failure
+bool writeWholeFile(const std::string& path, std::string_view data);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+// Local time formatted as "YYYY-MM-DD HH:MM:SS", the format used across the ledger
+std::string currentTimestamp();
+
+// Convert a "YYYY-MM-DD HH:MM:SS" local timestamp to seconds since epoch, or 0 if empty/invalid
+long long timestampToEpoch(const std::string& timestamp);
+
+// Convert seconds since epoch back to "YYYY-MM-DD HH:MM:SS" local time, or "" for 0
+std::string epochToTimestamp(long long epoch);
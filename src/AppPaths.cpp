@@ -0,0 +1,81 @@
+#include "AppPaths.h"
+#include "Config.h"
+#include "LedgerIndex.h"
+#include "LedgerSegments.h"
+#include "MasterData.h"
+#include "PanelIdReservation.h"
+#include "PanelJournal.h"
+#include "PanelMetadata.h"
+#include "PanelStatusLog.h"
+#include "PendingArtQueue.h"
+#include "Platform.h"
+#include <filesystem>
+#include <mutex>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+const AppPaths& appPaths() {
+    static const AppPaths paths = []() {
+        AppPaths p;
+        p.root = executableDirectory();
+        p.inputPanels = appDataPath(WolfTrackConfig::INPUT_PANELS_ROOT);
+        p.inputArchive = appDataPath(WolfTrackConfig::INPUT_PANELS_ARCHIVE);
+        p.pendingArt = appDataPath(WolfTrackConfig::PENDING_ART_ROOT);
+        p.completedArt = appDataPath(WolfTrackConfig::COMPLETED_ART_ROOT);
+        p.laserJobs = appDataPath(WolfTrackConfig::LASER_JOBS_ROOT);
+        p.masterDir = appDataPath("MasterData");
+        p.masterCsv = appDataPath(MASTER_CSV_PATH);
+        p.masterJournal = appDataPath(MASTER_JOURNAL_PATH);
+        p.masterIndex = appDataPath(MASTER_INDEX_PATH);
+        p.panelIdReservation = appDataPath(PANEL_ID_RESERVATION_PATH);
+        p.panelStatusLog = appDataPath(PANEL_STATUS_LOG_PATH);
+        p.pendingArtManifest = appDataPath(PENDING_ART_MANIFEST_PATH);
+        p.panelMetadataIndex = appDataPath(PANEL_METADATA_INDEX_PATH);
+        p.segmentsDir = appDataPath(LEDGER_SEGMENTS_DIR);
+        p.metricsFile = appDataPath(WolfTrackConfig::METRICS_FILE);
+        p.settingsFile = appDataPath("settings.ini");
+        return p;
+    }();
+    return paths;
+}
+
+// Folders this process has created or seen, by the exact string it was asked for
+static std::mutex s_knownDirsMutex;
+static std::unordered_set<std::string> s_knownDirs;
+
+static bool isKnownDirectory(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(s_knownDirsMutex);
+    return s_knownDirs.count(dir) != 0;
+}
+
+bool ensureDirectory(const std::string& dir) {
+    if (dir.empty() || isKnownDirectory(dir)) {
+        return true;
+    }
+
+    std::error_code ec;
+    fs::path path(dir);
+    bool parentKnown = isKnownDirectory(path.parent_path().string());
+    if (parentKnown) {
+        // One mkdir; it only looks further if something is already there
+        fs::create_directory(path, ec);
+    }
+    // Parent unknown, or it went away since it was seen
+    if (!parentKnown || ec) {
+        ec.clear();
+        fs::create_directories(path, ec);
+    }
+    if (ec) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_knownDirsMutex);
+    s_knownDirs.insert(dir);
+    return true;
+}
+
+void forgetDirectory(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(s_knownDirsMutex);
+    s_knownDirs.erase(dir);
+}
@@ -0,0 +1,290 @@
+#include "ArtworkPipeline.h"
+#include "AppPaths.h"
+#include "SessionState.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+enum ArtworkStage { STAGE_PARSE, STAGE_LAYOUT, STAGE_RENDER, STAGE_WRITE, STAGE_COUNT };
+
+static const char* const STAGE_NAMES[STAGE_COUNT] = {"parse", "layout", "render", "write"};
+
+// A panel on its way through the pipeline; each stage fills in the next part
+struct ArtworkPipeline::Item {
+    size_t index;
+    ArtworkJob job;
+    fs::path folder;
+    std::string payload;
+    DataMatrixSymbol symbol;
+    bool encoded = false;
+    std::string artSvg;
+    std::string labelSvg;
+    bool hasMetadata = false;
+    PanelMetadataRecord metadata{};
+    std::string info;           // panel_info.txt for a panel too long for the record
+    ArtworkResult result;
+};
+
+static long long microsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+ArtworkPipeline::ArtworkPipeline(const std::string& outputRoot, unsigned int workers, size_t queueCapacity)
+    : m_context(makeContext(outputRoot)) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        m_stages[i].name = STAGE_NAMES[i];
+        m_queues.push_back(std::make_unique<Queue>(queueCapacity));
+    }
+
+    // Parsing is trivial; the CPU-bound middle stages and the I/O-bound
+    // write stage get the whole pool so slow disks overlap with rendering
+    startStage(STAGE_PARSE, 1);
+    startStage(STAGE_LAYOUT, workers);
+    startStage(STAGE_RENDER, workers);
+    startStage(STAGE_WRITE, workers);
+}
+
+ArtworkPipeline::~ArtworkPipeline() {
+    finish();
+}
+
+ArtworkPipeline::Context ArtworkPipeline::makeContext(const std::string& outputRoot) {
+    Context context;
+    context.outputRoot = outputRoot;
+    context.stats = computeMasterStats();
+    context.generatedAt = timestampToEpoch(currentTimestamp());
+    return context;
+}
+
+ArtworkResult ArtworkPipeline::runInline(const std::string& outputRoot, ArtworkJob job) {
+    Context context = makeContext(outputRoot);
+    Item item;
+    item.index = 0;
+    item.job = std::move(job);
+    SvgWriter svg;
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        process(stage, item, svg, context);
+    }
+    return item.result;
+}
+
+void ArtworkPipeline::startStage(int stage, unsigned int workers) {
+    m_stages[stage].running = static_cast<int>(workers);
+    for (unsigned int i = 0; i < workers; ++i) {
+        m_threads.emplace_back(&ArtworkPipeline::runStage, this, stage);
+    }
+}
+
+void ArtworkPipeline::submit(ArtworkJob job) {
+    auto item = std::make_unique<Item>();
+    item->index = m_submitted++;
+    item->job = std::move(job);
+    m_queues[STAGE_PARSE]->push(std::move(item));
+}
+
+void ArtworkPipeline::runStage(int stage) {
+    Stage& counters = m_stages[stage];
+    SvgWriter svg;  // Reused for every panel this worker renders
+    std::unique_ptr<Item> item;
+    while (m_queues[stage]->pop(item)) {
+        auto start = std::chrono::steady_clock::now();
+        process(stage, *item, svg, m_context);
+        counters.busyMicros += microsSince(start);
+        counters.items++;
+
+        if (stage == STAGE_WRITE) {
+            std::lock_guard<std::mutex> lock(m_resultsMutex);
+            m_results.emplace_back(item->index, std::move(item->result));
+        } else {
+            start = std::chrono::steady_clock::now();
+            m_queues[stage + 1]->push(std::move(item));
+            counters.blockedMicros += microsSince(start);
+        }
+    }
+
+    // The last worker out tells the next stage no more items are coming
+    if (--counters.running == 0 && stage + 1 < STAGE_COUNT) {
+        m_queues[stage + 1]->close();
+    }
+}
+
+void ArtworkPipeline::process(int stage, Item& item, SvgWriter& svg, const Context& context) {
+    const Panel& panel = item.job.panel;
+    switch (stage) {
+        case STAGE_PARSE:
+            item.folder = fs::path(context.outputRoot) / panel.panelID;
+            item.payload = dataMatrixPayload(panel);
+            break;
+
+        case STAGE_LAYOUT:
+            item.encoded = encodeDataMatrix(item.payload, item.symbol);
+            break;
+
+        case STAGE_RENDER:
+            buildPanelArtSvg(panel, item.job.operatorName, svg);
+            item.artSvg = svg.str();
+            if (item.encoded) {
+                buildDataMatrixLabelSvg(panel, item.symbol, item.job.operatorName, svg);
+                item.labelSvg = svg.str();
+            }
+            item.hasMetadata = makePanelMetadata(panel, item.job.operatorName, context.stats.totalPanels,
+                                                 context.stats.totalPcbs, context.generatedAt, item.metadata);
+            if (!item.hasMetadata) {
+                item.info = formatPanelInfo(panel, item.job.operatorName, context.stats);
+            }
+            break;
+
+        case STAGE_WRITE: {
+            ArtworkResult& result = item.result;
+            result.panelID = panel.panelID;
+            result.ok = false;
+            if (!panel.panelID.empty() && ensureDirectory(item.folder.string())) {
+                std::string artPath = (item.folder / (panel.panelID + "_panel_art.svg")).string();
+                std::string labelPath = (item.folder / (panel.panelID + "_datamatrix.svg")).string();
+                bool artOk = writeWholeFile(artPath, item.artSvg);
+                if (!artOk) {
+                    // The folder may have been moved on since it was first made
+                    forgetDirectory(item.folder.string());
+                    artOk = ensureDirectory(item.folder.string()) && writeWholeFile(artPath, item.artSvg);
+                }
+                bool labelOk = item.encoded && writeWholeFile(labelPath, item.labelSvg);
+                if (item.hasMetadata) {
+                    writePanelMetadataFiles(item.folder.string(), item.metadata);
+                    result.metadata = item.metadata;
+                } else {
+                    writeWholeFile((item.folder / "panel_info.txt").string(), item.info);
+                }
+                result.artPath = artOk ? artPath : "";
+                result.labelPath = labelOk ? labelPath : "";
+                result.ok = artOk && labelOk;
+            }
+            break;
+        }
+    }
+}
+
+std::vector<ArtworkResult> ArtworkPipeline::finish() {
+    if (!m_finished) {
+        m_finished = true;
+        m_queues[STAGE_PARSE]->close();
+        for (std::thread& t : m_threads) {
+            t.join();
+        }
+    }
+
+    std::sort(m_results.begin(), m_results.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<ArtworkResult> results;
+    results.reserve(m_results.size());
+    for (auto& tagged : m_results) {
+        results.push_back(tagged.second);
+    }
+    return results;
+}
+
+std::vector<ArtworkStageTiming> ArtworkPipeline::timings() const {
+    std::vector<ArtworkStageTiming> out;
+    for (const Stage& stage : m_stages) {
+        out.push_back(ArtworkStageTiming{stage.name, stage.items.load(), stage.busyMicros.load(),
+                                         stage.blockedMicros.load()});
+    }
+    return out;
+}
+
+// Add panels whose artwork was written to the pending-work queue and the metadata index
+static void noteArtworkWritten(const std::vector<ArtworkResult>& results) {
+    std::vector<std::string> ids;
+    std::vector<PanelMetadataRecord> metadata;
+    for (const ArtworkResult& result : results) {
+        if (!result.artPath.empty()) {
+            ids.push_back(result.panelID);
+            metadata.push_back(result.metadata);
+        }
+    }
+    recordPanelMetadata(metadata);
+    notePanelArtPending(ids);
+}
+
+std::vector<ArtworkResult> generateArtworkForPanels(const std::vector<Panel>& panels,
+                                                    const std::string& operatorName,
+                                                    std::vector<ArtworkStageTiming>* timings) {
+    // Writing a lasered panel again would recreate its PendingArt folder and
+    // queue it a second time, although its artwork is already in CompletedArt
+    std::vector<ArtworkResult> results(panels.size());
+    std::vector<size_t> toWrite;
+    for (size_t i = 0; i < panels.size(); ++i) {
+        results[i].panelID = panels[i].panelID;
+        results[i].ok = false;
+        results[i].alreadyLasered = currentPanelStatus(panels[i].panelID) == PanelStatus::Lasered;
+        if (!results[i].alreadyLasered) {
+            toWrite.push_back(i);
+        }
+    }
+
+    std::vector<ArtworkResult> written;
+    if (toWrite.size() == 1 && timings == nullptr) {
+        // One panel (the GUI's Generate button) gains nothing from worker threads
+        written.push_back(ArtworkPipeline::runInline(getPendingArtRoot(), ArtworkJob{panels[toWrite[0]], operatorName}));
+    } else if (!toWrite.empty()) {
+        // No point starting more workers per stage than there are panels
+        unsigned int workers = std::max(1u, std::thread::hardware_concurrency());
+        workers = static_cast<unsigned int>(std::min<size_t>(workers, toWrite.size()));
+        ArtworkPipeline pipeline(getPendingArtRoot(), workers);
+        for (size_t i : toWrite) {
+            pipeline.submit(ArtworkJob{panels[i], operatorName});
+        }
+        written = pipeline.finish();
+        if (timings != nullptr) {
+            *timings = pipeline.timings();
+        }
+    }
+    for (size_t k = 0; k < written.size(); ++k) {
+        results[toWrite[k]] = written[k];
+    }
+    noteArtworkWritten(written);
+    return results;
+}
+
+int regenerateAllArtwork(std::vector<ArtworkStageTiming>* timings) {
+    ArtworkPipeline pipeline(getPendingArtRoot());
+
+    // Streams straight from the journal; back-pressure keeps memory flat.
+    // Lasered panels are finished and their artwork lives in CompletedArt.
+    forEachMasterPanel([&pipeline](const Panel& panel) {
+        if (panel.status == PanelStatus::Lasered) {
+            return;
+        }
+        std::string op = panel.operatorName.empty() ? g_currentOperator : panel.operatorName;
+        pipeline.submit(ArtworkJob{panel, op});
+    });
+
+    int failed = 0;
+    std::vector<ArtworkResult> results = pipeline.finish();
+    for (const ArtworkResult& result : results) {
+        if (!result.ok) {
+            failed++;
+        }
+    }
+    if (timings != nullptr) {
+        *timings = pipeline.timings();
+    }
+    noteArtworkWritten(results);
+    return failed;
+}
+
+std::string formatArtworkTimings(const std::vector<ArtworkStageTiming>& timings) {
+    std::ostringstream oss;
+    for (const ArtworkStageTiming& t : timings) {
+        oss << t.stage << ": " << t.items << " panels, busy " << t.busyMicros / 1000
+            << " ms, blocked " << t.blockedMicros / 1000 << " ms\n";
+    }
+    return oss.str();
+}
@@ -0,0 +1,193 @@
+#include "BatchImport.h"
+#include "MasterData.h"
+#include "Config.h"
+#include "SessionState.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+// One input file and what parsing it produced
+struct BatchEntry {
+    fs::path path;
+    fs::file_time_type writeTime;
+    std::vector<Panel> panels;  // One per data row in the file
+    bool parsed;
+};
+
+// List the CSVs waiting in inputDir, oldest first so PanelIDs follow arrival order
+static std::vector<BatchEntry> listInputFiles(const std::string& inputDir) {
+    std::vector<BatchEntry> entries;
+    std::error_code ec;
+    for (const auto& item : fs::directory_iterator(inputDir, ec)) {
+        if (!item.is_regular_file(ec)) {
+            continue;
+        }
+        std::string ext = item.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext != ".csv") {
+            continue;
+        }
+        BatchEntry entry;
+        entry.path = item.path();
+        entry.writeTime = item.last_write_time(ec);
+        entry.parsed = false;
+        entries.push_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const BatchEntry& a, const BatchEntry& b) {
+        if (a.writeTime != b.writeTime) {
+            return a.writeTime < b.writeTime;
+        }
+        return a.path.filename() < b.path.filename();
+    });
+    return entries;
+}
+
+// Parse all entries on a small pool of worker threads. Each worker only
+// touches its own entries, so no locking is needed.
+static void parseEntriesInParallel(std::vector<BatchEntry>& entries) {
+    unsigned int workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = std::min<unsigned int>(workerCount, static_cast<unsigned int>(entries.size()));
+
+    std::atomic<size_t> next{0};
+    auto worker = [&entries, &next]() {
+        for (size_t i = next++; i < entries.size(); i = next++) {
+            entries[i].parsed = parsePanelsCsvFile(entries[i].path.string(), entries[i].panels);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+BatchImportSummary runBatchImport(const std::string& inputDir) {
+    BatchImportSummary summary;
+    summary.filesFound = 0;
+    summary.panelsImported = 0;
+    summary.filesFailed = 0;
+    summary.artworkFailed = 0;
+    summary.ledgerError = LedgerError::None;
+
+    std::vector<BatchEntry> entries = listInputFiles(inputDir);
+    summary.filesFound = static_cast<int>(entries.size());
+    if (entries.empty()) {
+        return summary;
+    }
+
+    parseEntriesInParallel(entries);
+
+    std::vector<Panel> panels;
+    std::vector<const BatchEntry*> imported;
+    SerialIndex batchSerials;  // Serials accepted earlier in this batch
+    for (BatchEntry& entry : entries) {
+        if (!entry.parsed) {
+            summary.filesFailed++;
+            summary.failedFiles.push_back(entry.path.string());
+            continue;
+        }
+
+        // Check against the ledger and against files accepted earlier in the batch
+        std::vector<SerialDuplicate> duplicates = findDuplicateSerials(entry.panels);
+        for (const Panel& panel : entry.panels) {
+            for (size_t i = 0; i < panel.pcbSerials.size(); ++i) {
+                SerialLocation earlier;
+                if (!panel.pcbSerials[i].empty() && batchSerials.findSerial(panel.pcbSerials[i], earlier)) {
+                    duplicates.push_back(SerialDuplicate{panel.pcbSerials[i], static_cast<int>(i) + 1, earlier});
+                }
+            }
+        }
+        summary.duplicateSerials.insert(summary.duplicateSerials.end(), duplicates.begin(), duplicates.end());
+        if (!duplicates.empty() && WolfTrackConfig::REJECT_DUPLICATE_SERIALS) {
+            summary.filesFailed++;
+            summary.failedFiles.push_back(entry.path.string());
+            continue;
+        }
+
+        // Reserved PanelIDs, unique across every station sharing the ledger
+        if (assignPanelIds(entry.panels) != LedgerError::None) {
+            summary.filesFailed++;
+            summary.failedFiles.push_back(entry.path.string());
+            continue;
+        }
+        for (const Panel& panel : entry.panels) {
+            batchSerials.addPanel(panel, -1);
+            panels.push_back(panel);
+        }
+        imported.push_back(&entry);
+    }
+
+    // One durable append for the whole batch
+    summary.ledgerError = appendPanelsToMaster(panels);
+    if (summary.ledgerError != LedgerError::None) {
+        for (const BatchEntry* entry : imported) {
+            summary.filesFailed++;
+            summary.failedFiles.push_back(entry->path.string());
+        }
+        return summary;
+    }
+
+    summary.panelsImported = static_cast<int>(panels.size());
+    if (!panels.empty()) {
+        summary.firstPanelID = panels.front().panelID;
+        summary.lastPanelID = panels.back().panelID;
+    }
+
+    // Archive, then remove the source so the input folder is drained
+    for (const BatchEntry* entry : imported) {
+        if (!moveInputPanelToArchive(entry->path.string())) {
+            summary.filesFailed++;
+            summary.failedFiles.push_back(entry->path.string());
+            continue;
+        }
+        std::error_code ec;
+        fs::remove(entry->path, ec);
+    }
+
+    // Artwork for the whole batch goes through the parallel pipeline
+    if (WolfTrackConfig::BATCH_IMPORT_GENERATES_ART) {
+        for (const ArtworkResult& result : generateArtworkForPanels(panels, g_currentOperator, &summary.artworkTimings)) {
+            if (!result.ok) {
+                summary.artworkFailed++;
+            } else {
+                setPanelStatus(result.panelID, PanelStatus::ReadyForLaser);
+            }
+        }
+    }
+
+    return summary;
+}
+
+std::string formatBatchImportSummary(const BatchImportSummary& summary) {
+    std::ostringstream oss;
+    oss << "Batch import summary\n";
+    oss << "Files found: " << summary.filesFound << "\n";
+    oss << "Panels imported: " << summary.panelsImported << "\n";
+    oss << "Files failed: " << summary.filesFailed << "\n";
+    if (summary.ledgerError != LedgerError::None) {
+        oss << "Ledger error: " << ledgerErrorToString(summary.ledgerError) << "\n";
+    }
+    if (summary.panelsImported > 0) {
+        oss << "PanelIDs: " << summary.firstPanelID << " - " << summary.lastPanelID << "\n";
+    }
+    if (!summary.artworkTimings.empty()) {
+        oss << "Artwork failed: " << summary.artworkFailed << "\n";
+        oss << formatArtworkTimings(summary.artworkTimings);
+    }
+    for (const std::string& path : summary.failedFiles) {
+        oss << "Failed: " << path << "\n";
+    }
+    if (!summary.duplicateSerials.empty()) {
+        oss << "Duplicate serials:\n"
+            << formatDuplicateSerials(summary.duplicateSerials, summary.duplicateSerials.size());
+    }
+    return oss.str();
+}
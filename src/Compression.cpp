@@ -0,0 +1,148 @@
+#include "Compression.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static const char COMPRESSION_TAG[4] = {'W', 'T', 'Z', '1'};
+static const size_t HEADER_SIZE = 12;   // Tag + 64-bit little-endian uncompressed size
+static const size_t MIN_MATCH = 4;
+static const size_t MAX_OFFSET = 65535;
+static const int HASH_BITS = 14;
+
+static uint32_t read32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Lengths that do not fit in a token nibble continue in bytes of up to 255
+static void writeLength(std::string& out, size_t length) {
+    while (length >= 255) {
+        out += static_cast<char>(255);
+        length -= 255;
+    }
+    out += static_cast<char>(length);
+}
+
+static bool readLength(std::string_view in, size_t& pos, size_t& length) {
+    unsigned char byte;
+    do {
+        if (pos >= in.size()) {
+            return false;
+        }
+        byte = static_cast<unsigned char>(in[pos++]);
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// One sequence: token, literal run, then (unless it is the last) the match
+static void writeSequence(std::string& out, std::string_view literals, size_t offset, size_t matchLength) {
+    size_t litNibble = literals.size() < 15 ? literals.size() : 15;
+    size_t matchExtra = matchLength == 0 ? 0 : matchLength - MIN_MATCH;
+    size_t matchNibble = matchExtra < 15 ? matchExtra : 15;
+    out += static_cast<char>((litNibble << 4) | matchNibble);
+    if (litNibble == 15) {
+        writeLength(out, literals.size() - 15);
+    }
+    out.append(literals.data(), literals.size());
+    if (matchLength == 0) {
+        return;
+    }
+    out += static_cast<char>(offset & 0xFF);
+    out += static_cast<char>(offset >> 8);
+    if (matchNibble == 15) {
+        writeLength(out, matchExtra - 15);
+    }
+}
+
+std::string compressBytes(std::string_view input) {
+    std::string out(COMPRESSION_TAG, sizeof(COMPRESSION_TAG));
+    unsigned long long size = input.size();
+    for (int i = 0; i < 8; ++i) {
+        out += static_cast<char>(size >> (i * 8));
+    }
+    out.reserve(HEADER_SIZE + input.size() / 2 + 16);
+
+    // Last position seen for each 4-byte hash, stored +1 so 0 means empty
+    std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+    const char* data = input.data();
+    size_t n = input.size();
+    size_t anchor = 0;
+    size_t i = 0;
+    while (i + MIN_MATCH <= n) {
+        uint32_t seq = read32(data + i);
+        uint32_t h = (seq * 2654435761u) >> (32 - HASH_BITS);
+        size_t candidate = table[h];
+        table[h] = static_cast<uint32_t>(i + 1);
+
+        if (candidate != 0 && i - (candidate - 1) <= MAX_OFFSET && read32(data + candidate - 1) == seq) {
+            size_t match = candidate - 1;
+            size_t length = MIN_MATCH;
+            while (i + length < n && data[match + length] == data[i + length]) {
+                length++;
+            }
+            writeSequence(out, input.substr(anchor, i - anchor), i - match, length);
+            i += length;
+            anchor = i;
+        } else {
+            i++;
+        }
+    }
+    writeSequence(out, input.substr(anchor), 0, 0);
+    return out;
+}
+
+bool decompressBytes(std::string_view in, std::string& out) {
+    if (in.size() < HEADER_SIZE || std::memcmp(in.data(), COMPRESSION_TAG, sizeof(COMPRESSION_TAG)) != 0) {
+        return false;
+    }
+    unsigned long long size = 0;
+    for (int i = 0; i < 8; ++i) {
+        size |= static_cast<unsigned long long>(static_cast<unsigned char>(in[4 + i])) << (i * 8);
+    }
+    // A sequence can at most expand ~255x; anything bigger is a corrupt header
+    if (size > (in.size() - HEADER_SIZE) * 256 + 16) {
+        return false;
+    }
+
+    out.clear();
+    out.reserve(static_cast<size_t>(size));
+    size_t pos = HEADER_SIZE;
+    while (pos < in.size()) {
+        unsigned char token = static_cast<unsigned char>(in[pos++]);
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(in, pos, literals)) {
+            return false;
+        }
+        if (literals > in.size() - pos || out.size() + literals > size) {
+            return false;
+        }
+        out.append(in.data() + pos, literals);
+        pos += literals;
+        if (pos == in.size()) {
+            break;  // The last sequence has no match
+        }
+
+        if (in.size() - pos < 2) {
+            return false;
+        }
+        size_t offset = static_cast<unsigned char>(in[pos]) | (static_cast<unsigned char>(in[pos + 1]) << 8);
+        pos += 2;
+        size_t length = token & 0x0F;
+        if (length == 15 && !readLength(in, pos, length)) {
+            return false;
+        }
+        length += MIN_MATCH;
+        if (offset == 0 || offset > out.size() || out.size() + length > size) {
+            return false;
+        }
+        // Byte by byte: a match may overlap the bytes it is producing
+        size_t from = out.size() - offset;
+        for (size_t k = 0; k < length; ++k) {
+            out += out[from + k];
+        }
+    }
+    return out.size() == size;
+}
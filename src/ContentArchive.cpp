@@ -0,0 +1,144 @@
+#include "ContentArchive.h"
+#include "AppPaths.h"
+#include "Compression.h"
+#include "Sha256.h"
+#include "SvgWriter.h"
+#include "Timestamp.h"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// Serialises manifest appends from the GUI worker and batch imports in one process
+static std::mutex s_manifestMutex;
+
+static bool readWholeFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    if (file.bad()) {
+        return false;
+    }
+    out = buffer.str();
+    return true;
+}
+
+std::string archiveObjectPath(const std::string& archiveDir, const std::string& hash) {
+    return (fs::path(archiveDir) / "objects" / hash.substr(0, 2) / (hash + ".wtz")).string();
+}
+
+// Store the compressed bytes unless an object with this hash already exists.
+// Written to a temporary name first so a crash never leaves a torn object.
+static bool storeObject(const std::string& archiveDir, const std::string& hash, const std::string& content) {
+    fs::path objectPath = archiveObjectPath(archiveDir, hash);
+    std::error_code ec;
+    if (fs::exists(objectPath, ec)) {
+        return true;
+    }
+    if (!ensureDirectory(objectPath.parent_path().string())) {
+        return false;
+    }
+
+    fs::path tempPath = objectPath;
+    tempPath += ".tmp";
+    if (!writeWholeFile(tempPath.string(), compressBytes(content))) {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    fs::rename(tempPath, objectPath, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool archiveFileByContent(const std::string& archiveDir, const std::string& sourcePath, ArchiveEntry* entry) {
+    try {
+        std::string content;
+        if (!readWholeFile(sourcePath, content)) {
+            return false;
+        }
+
+        ArchiveEntry record;
+        record.archivedAt = currentTimestamp();
+        record.hash = sha256Hex(content);
+        record.size = content.size();
+        record.originalName = fs::path(sourcePath).filename().string();
+
+        if (!storeObject(archiveDir, record.hash, content)) {
+            return false;
+        }
+
+        // Tabs and newlines would break the manifest; file names never need them
+        std::string name = record.originalName;
+        for (char& c : name) {
+            if (c == '\t' || c == '\n' || c == '\r') {
+                c = ' ';
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(s_manifestMutex);
+        std::ofstream manifest(fs::path(archiveDir) / ARCHIVE_MANIFEST_NAME, std::ios::app | std::ios::binary);
+        if (!manifest.is_open()) {
+            return false;
+        }
+        manifest << record.archivedAt << '\t' << record.hash << '\t' << record.size << '\t' << name << '\n';
+        manifest.flush();
+        if (!manifest) {
+            return false;
+        }
+
+        if (entry != nullptr) {
+            *entry = record;
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool readArchiveManifest(const std::string& archiveDir, std::vector<ArchiveEntry>& entries) {
+    entries.clear();
+    std::ifstream manifest(fs::path(archiveDir) / ARCHIVE_MANIFEST_NAME, std::ios::binary);
+    if (!manifest.is_open()) {
+        return true;
+    }
+
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::istringstream fields(line);
+        ArchiveEntry entry;
+        std::string size;
+        if (!std::getline(fields, entry.archivedAt, '\t') || !std::getline(fields, entry.hash, '\t') ||
+            !std::getline(fields, size, '\t') || !std::getline(fields, entry.originalName)) {
+            continue;  // Skip a line torn by a crash mid-append
+        }
+        try {
+            entry.size = std::stoull(size);
+        } catch (...) {
+            continue;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+bool restoreArchivedFile(const std::string& archiveDir, const std::string& hash, const std::string& destPath) {
+    try {
+        std::string compressed;
+        std::string content;
+        if (!readWholeFile(archiveObjectPath(archiveDir, hash), compressed) ||
+            !decompressBytes(compressed, content) || sha256Hex(content) != hash) {
+            return false;
+        }
+        return writeWholeFile(destPath, content);
+    } catch (...) {
+        return false;
+    }
+}
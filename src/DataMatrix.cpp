@@ -0,0 +1,349 @@
+#include "DataMatrix.h"
+#include <algorithm>
+
+// ECC200 encoder following ISO/IEC 16022: ASCII encodation, Reed-Solomon over
+// GF(256) with the 0x12D field polynomial, and the standard module placement.
+
+// GF(256) log/antilog tables, built by the compiler
+struct GaloisTables {
+    uint8_t exp[512];
+    uint8_t log[256];
+};
+
+static constexpr GaloisTables makeGaloisTables() {
+    GaloisTables t{};
+    int x = 1;
+    for (int i = 0; i < 255; ++i) {
+        t.exp[i] = static_cast<uint8_t>(x);
+        t.exp[i + 255] = static_cast<uint8_t>(x);
+        t.log[x] = static_cast<uint8_t>(i);
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x12D;
+        }
+    }
+    return t;
+}
+
+static constexpr GaloisTables GF = makeGaloisTables();
+
+static_assert(GF.exp[8] == 0x2D, "GF(256) table uses the DataMatrix polynomial");
+
+static uint8_t gfMultiply(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return GF.exp[GF.log[a] + GF.log[b]];
+}
+
+// Square ECC200 symbol sizes
+struct SymbolSize {
+    int size;           // Modules per side
+    int regionSize;     // Data modules per side of one region
+    int regions;        // Regions per side
+    int dataCodewords;
+    int eccCodewords;
+    int blocks;         // Interleaved Reed-Solomon blocks
+};
+
+static const SymbolSize SYMBOL_SIZES[] = {
+    {10, 8, 1, 3, 5, 1},        {12, 10, 1, 5, 7, 1},       {14, 12, 1, 8, 10, 1},
+    {16, 14, 1, 12, 12, 1},     {18, 16, 1, 18, 14, 1},     {20, 18, 1, 22, 18, 1},
+    {22, 20, 1, 30, 20, 1},     {24, 22, 1, 36, 24, 1},     {26, 24, 1, 44, 28, 1},
+    {32, 14, 2, 62, 36, 1},     {36, 16, 2, 86, 42, 1},     {40, 18, 2, 114, 48, 1},
+    {44, 20, 2, 144, 56, 1},    {48, 22, 2, 174, 68, 1},    {52, 24, 2, 204, 84, 2},
+    {64, 14, 4, 280, 112, 2},   {72, 16, 4, 368, 144, 4},   {80, 18, 4, 456, 192, 4},
+    {88, 20, 4, 576, 224, 4},   {96, 22, 4, 696, 272, 4},   {104, 24, 4, 816, 336, 6},
+    {120, 18, 6, 1050, 408, 6}, {132, 20, 6, 1304, 496, 8}, {144, 22, 6, 1558, 620, 10},
+};
+
+// ASCII encodation: digit pairs share a codeword, bytes above 127 use Upper Shift
+static std::vector<uint8_t> encodeAscii(std::string_view text) {
+    std::vector<uint8_t> codewords;
+    codewords.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        bool pair = i + 1 < text.size() && c >= '0' && c <= '9'
+                    && text[i + 1] >= '0' && text[i + 1] <= '9';
+        if (pair) {
+            codewords.push_back(static_cast<uint8_t>(130 + (c - '0') * 10 + (text[i + 1] - '0')));
+            ++i;
+        } else if (c < 128) {
+            codewords.push_back(static_cast<uint8_t>(c + 1));
+        } else {
+            codewords.push_back(235);
+            codewords.push_back(static_cast<uint8_t>(c - 127));
+        }
+    }
+    return codewords;
+}
+
+// Fill unused data capacity: one plain pad, then pseudo-randomised pads
+static void padCodewords(std::vector<uint8_t>& codewords, int dataCodewords) {
+    if (static_cast<int>(codewords.size()) < dataCodewords) {
+        codewords.push_back(129);
+    }
+    while (static_cast<int>(codewords.size()) < dataCodewords) {
+        int position = static_cast<int>(codewords.size()) + 1;
+        int value = 129 + ((149 * position) % 253) + 1;
+        if (value > 254) {
+            value -= 254;
+        }
+        codewords.push_back(static_cast<uint8_t>(value));
+    }
+}
+
+// Reed-Solomon check codewords for each interleaved block, written after the data
+static void appendErrorCorrection(std::vector<uint8_t>& codewords, const SymbolSize& symbol) {
+    int eccPerBlock = symbol.eccCodewords / symbol.blocks;
+
+    // Generator polynomial (x + a^1)(x + a^2)...(x + a^n), lowest power first
+    std::vector<uint8_t> generator(eccPerBlock + 1, 0);
+    generator[0] = 1;
+    for (int i = 1; i <= eccPerBlock; ++i) {
+        for (int k = i; k > 0; --k) {
+            generator[k] = generator[k - 1] ^ gfMultiply(generator[k], GF.exp[i]);
+        }
+        generator[0] = gfMultiply(generator[0], GF.exp[i]);
+    }
+
+    codewords.resize(symbol.dataCodewords + symbol.eccCodewords);
+    std::vector<uint8_t> ecc(eccPerBlock);
+    for (int block = 0; block < symbol.blocks; ++block) {
+        std::fill(ecc.begin(), ecc.end(), 0);
+        for (int i = block; i < symbol.dataCodewords; i += symbol.blocks) {
+            uint8_t factor = ecc[eccPerBlock - 1] ^ codewords[i];
+            for (int k = eccPerBlock - 1; k > 0; --k) {
+                ecc[k] = ecc[k - 1] ^ gfMultiply(factor, generator[k]);
+            }
+            ecc[0] = gfMultiply(factor, generator[0]);
+        }
+        for (int k = 0; k < eccPerBlock; ++k) {
+            codewords[symbol.dataCodewords + block + k * symbol.blocks] = ecc[eccPerBlock - 1 - k];
+        }
+    }
+}
+
+// Standard ECC200 placement of codeword bits into the mapping matrix (the
+// symbol with its finder patterns removed). Cells hold 10 * codeword + bit,
+// with codewords numbered from 1 and bit 1 the most significant; 0 is unset.
+class ModulePlacement {
+public:
+    ModulePlacement(int rows, int cols) : m_rows(rows), m_cols(cols), m_cells(rows * cols, 0) {}
+
+    const std::vector<int>& place() {
+        int codeword = 1;
+        int row = 4;
+        int col = 0;
+        do {
+            // The four corner cases
+            if (row == m_rows && col == 0) {
+                corner1(codeword++);
+            }
+            if (row == m_rows - 2 && col == 0 && m_cols % 4) {
+                corner2(codeword++);
+            }
+            if (row == m_rows - 2 && col == 0 && m_cols % 8 == 4) {
+                corner3(codeword++);
+            }
+            if (row == m_rows + 4 && col == 2 && !(m_cols % 8)) {
+                corner4(codeword++);
+            }
+            // Sweep up and to the right
+            do {
+                if (row < m_rows && col >= 0 && !m_cells[row * m_cols + col]) {
+                    utah(row, col, codeword++);
+                }
+                row -= 2;
+                col += 2;
+            } while (row >= 0 && col < m_cols);
+            row += 1;
+            col += 3;
+            // Then down and to the left
+            do {
+                if (row >= 0 && col < m_cols && !m_cells[row * m_cols + col]) {
+                    utah(row, col, codeword++);
+                }
+                row += 2;
+                col -= 2;
+            } while (row < m_rows && col >= 0);
+            row += 3;
+            col += 1;
+        } while (row < m_rows || col < m_cols);
+
+        // Sizes that leave the bottom-right 2x2 unused get a fixed pattern
+        if (!m_cells[m_rows * m_cols - 1]) {
+            m_cells[m_rows * m_cols - 1] = 1;
+            m_cells[m_rows * m_cols - m_cols - 2] = 1;
+        }
+        return m_cells;
+    }
+
+private:
+    void module(int row, int col, int codeword, int bit) {
+        if (row < 0) {
+            row += m_rows;
+            col += 4 - ((m_rows + 4) % 8);
+        }
+        if (col < 0) {
+            col += m_cols;
+            row += 4 - ((m_cols + 4) % 8);
+        }
+        m_cells[row * m_cols + col] = 10 * codeword + bit;
+    }
+
+    // The usual L-shaped 8-module codeword
+    void utah(int row, int col, int codeword) {
+        module(row - 2, col - 2, codeword, 1);
+        module(row - 2, col - 1, codeword, 2);
+        module(row - 1, col - 2, codeword, 3);
+        module(row - 1, col - 1, codeword, 4);
+        module(row - 1, col, codeword, 5);
+        module(row, col - 2, codeword, 6);
+        module(row, col - 1, codeword, 7);
+        module(row, col, codeword, 8);
+    }
+
+    void corner1(int codeword) {
+        module(m_rows - 1, 0, codeword, 1);
+        module(m_rows - 1, 1, codeword, 2);
+        module(m_rows - 1, 2, codeword, 3);
+        module(0, m_cols - 2, codeword, 4);
+        module(0, m_cols - 1, codeword, 5);
+        module(1, m_cols - 1, codeword, 6);
+        module(2, m_cols - 1, codeword, 7);
+        module(3, m_cols - 1, codeword, 8);
+    }
+
+    void corner2(int codeword) {
+        module(m_rows - 3, 0, codeword, 1);
+        module(m_rows - 2, 0, codeword, 2);
+        module(m_rows - 1, 0, codeword, 3);
+        module(0, m_cols - 4, codeword, 4);
+        module(0, m_cols - 3, codeword, 5);
+        module(0, m_cols - 2, codeword, 6);
+        module(0, m_cols - 1, codeword, 7);
+        module(1, m_cols - 1, codeword, 8);
+    }
+
+    void corner3(int codeword) {
+        module(m_rows - 3, 0, codeword, 1);
+        module(m_rows - 2, 0, codeword, 2);
+        module(m_rows - 1, 0, codeword, 3);
+        module(0, m_cols - 2, codeword, 4);
+        module(0, m_cols - 1, codeword, 5);
+        module(1, m_cols - 1, codeword, 6);
+        module(2, m_cols - 1, codeword, 7);
+        module(3, m_cols - 1, codeword, 8);
+    }
+
+    void corner4(int codeword) {
+        module(m_rows - 1, 0, codeword, 1);
+        module(m_rows - 1, m_cols - 1, codeword, 2);
+        module(0, m_cols - 3, codeword, 3);
+        module(0, m_cols - 2, codeword, 4);
+        module(0, m_cols - 1, codeword, 5);
+        module(1, m_cols - 3, codeword, 6);
+        module(1, m_cols - 2, codeword, 7);
+        module(1, m_cols - 1, codeword, 8);
+    }
+
+    int m_rows;
+    int m_cols;
+    std::vector<int> m_cells;
+};
+
+static const SymbolSize* chooseSymbolSize(size_t dataCodewords) {
+    for (const SymbolSize& symbol : SYMBOL_SIZES) {
+        if (static_cast<size_t>(symbol.dataCodewords) >= dataCodewords) {
+            return &symbol;
+        }
+    }
+    return nullptr;
+}
+
+// Data and check codewords for text in the smallest symbol that fits it
+static const SymbolSize* encodeCodewords(std::string_view text, std::vector<uint8_t>& codewords) {
+    codewords = encodeAscii(text);
+    const SymbolSize* symbol = chooseSymbolSize(codewords.size());
+    if (symbol == nullptr) {
+        return nullptr;
+    }
+    padCodewords(codewords, symbol->dataCodewords);
+    appendErrorCorrection(codewords, *symbol);
+    return symbol;
+}
+
+bool encodeDataMatrixCodewords(std::string_view text, int& symbolSize, std::vector<uint8_t>& codewords) {
+    const SymbolSize* symbol = encodeCodewords(text, codewords);
+    if (symbol == nullptr) {
+        return false;
+    }
+    symbolSize = symbol->size;
+    return true;
+}
+
+bool encodeDataMatrix(std::string_view text, DataMatrixSymbol& out) {
+    std::vector<uint8_t> codewords;
+    const SymbolSize* symbol = encodeCodewords(text, codewords);
+    if (symbol == nullptr) {
+        return false;
+    }
+    int size = symbol->size;
+
+    int mappingSize = symbol->regionSize * symbol->regions;
+    ModulePlacement placement(mappingSize, mappingSize);
+    const std::vector<int>& cells = placement.place();
+
+    out.size = size;
+    out.modules.assign(static_cast<size_t>(size) * size, 0);
+    int block = symbol->regionSize + 2;
+    for (int row = 0; row < size; ++row) {
+        int regionRow = row % block;
+        for (int col = 0; col < size; ++col) {
+            int regionCol = col % block;
+            bool dark;
+            if (regionCol == 0 || regionRow == block - 1) {
+                dark = true;                        // Solid L finder edge
+            } else if (regionRow == 0) {
+                dark = regionCol % 2 == 0;          // Alternating top timing edge
+            } else if (regionCol == block - 1) {
+                dark = regionRow % 2 == 1;          // Alternating right timing edge
+            } else {
+                int mapRow = (row / block) * symbol->regionSize + regionRow - 1;
+                int mapCol = (col / block) * symbol->regionSize + regionCol - 1;
+                int cell = cells[mapRow * mappingSize + mapCol];
+                if (cell < 10) {
+                    dark = cell == 1;               // Fixed corner pattern
+                } else {
+                    int codeword = cell / 10 - 1;
+                    int bit = cell % 10;
+                    dark = (codewords[codeword] >> (8 - bit)) & 1;
+                }
+            }
+            out.modules[static_cast<size_t>(row) * size + col] = dark ? 1 : 0;
+        }
+    }
+    return true;
+}
+
+void writeDataMatrixSvgPath(const DataMatrixSymbol& symbol, int x, int y, int moduleSize, SvgWriter& svg) {
+    svg.raw("  <path fill=\"black\" d=\"");
+    for (int row = 0; row < symbol.size; ++row) {
+        int col = 0;
+        while (col < symbol.size) {
+            if (!symbol.dark(row, col)) {
+                ++col;
+                continue;
+            }
+            int start = col;
+            while (col < symbol.size && symbol.dark(row, col)) {
+                ++col;
+            }
+            int width = (col - start) * moduleSize;
+            svg.raw("M").number(x + start * moduleSize).raw(",").number(y + row * moduleSize)
+               .raw("h").number(width).raw("v").number(moduleSize).raw("h-").number(width).raw("z");
+        }
+    }
+    svg.raw("\"/>\n");
+}
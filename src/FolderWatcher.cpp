@@ -0,0 +1,140 @@
+#include "FolderWatcher.h"
+#include "Platform.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <map>
+
+namespace fs = std::filesystem;
+
+// How long to wait between checks while a file is still settling, and while idle
+static const std::chrono::milliseconds SETTLE_POLL(50);
+static const std::chrono::milliseconds IDLE_POLL(250);
+
+// Rescans on every timeout; the fallback for shares without notifications
+class PollingBackend : public WatchBackend {
+public:
+    bool wait(std::chrono::milliseconds timeout) override {
+        std::this_thread::sleep_for(timeout);
+        return true;
+    }
+    const char* name() const override { return "polling"; }
+};
+
+// Operating-system change notifications for one folder
+class NativeBackend : public WatchBackend {
+public:
+    explicit NativeBackend(const std::string& dir) : m_notifier(dir) {}
+    bool ok() const { return m_notifier.ok(); }
+
+    bool wait(std::chrono::milliseconds timeout) override { return m_notifier.wait(timeout); }
+    const char* name() const override { return m_notifier.name(); }
+
+private:
+    DirectoryChangeNotifier m_notifier;
+};
+
+std::unique_ptr<WatchBackend> createWatchBackend(const std::string& dir, WatchBackendKind kind) {
+    if (kind != WatchBackendKind::Polling) {
+        auto native = std::make_unique<NativeBackend>(dir);
+        if (native->ok()) {
+            return native;
+        }
+        if (kind == WatchBackendKind::Native) {
+            return nullptr;
+        }
+    }
+    return std::make_unique<PollingBackend>();
+}
+
+FolderWatcher::FolderWatcher(const std::string& dir, std::function<void(const std::string&)> onFileReady,
+                             WatchBackendKind kind, std::chrono::milliseconds settleTime)
+    : m_dir(dir), m_onFileReady(std::move(onFileReady)), m_settleTime(settleTime) {
+    m_backend = createWatchBackend(dir, kind);
+    if (!m_backend) {
+        m_backend = createWatchBackend(dir, WatchBackendKind::Polling);
+    }
+    m_thread = std::thread(&FolderWatcher::run, this);
+}
+
+FolderWatcher::~FolderWatcher() {
+    stop();
+}
+
+void FolderWatcher::stop() {
+    m_stopping = true;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+// What the watcher last saw of one CSV in the folder
+struct WatchedFile {
+    uintmax_t size;
+    fs::file_time_type writeTime;
+    std::chrono::steady_clock::time_point changedAt;
+    bool reported;
+};
+
+static bool isCsv(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".csv";
+}
+
+void FolderWatcher::run() {
+    std::map<std::string, WatchedFile> files;
+    bool baseline = true;  // First scan only records what is already there
+    bool changed = true;
+
+    while (!m_stopping) {
+        auto now = std::chrono::steady_clock::now();
+        bool settling = false;
+
+        if (changed) {
+            std::map<std::string, WatchedFile> seen;
+            std::error_code ec;
+            for (const auto& item : fs::directory_iterator(m_dir, ec)) {
+                std::error_code itemEc;
+                if (!item.is_regular_file(itemEc) || !isCsv(item.path())) {
+                    continue;
+                }
+                std::string key = item.path().string();
+                WatchedFile current;
+                current.size = item.file_size(itemEc);
+                current.writeTime = item.last_write_time(itemEc);
+                current.changedAt = now;
+                current.reported = baseline;
+
+                auto previous = files.find(key);
+                if (previous != files.end()) {
+                    const WatchedFile& old = previous->second;
+                    current.reported = old.reported;
+                    if (old.size == current.size && old.writeTime == current.writeTime) {
+                        current.changedAt = old.changedAt;
+                    }
+                }
+
+                // Report once the file has stopped changing and its writer is done
+                if (!current.reported) {
+                    if (now - current.changedAt >= m_settleTime && !isFileOpenByWriter(key)) {
+                        current.reported = true;
+                        m_onFileReady(key);
+                    } else {
+                        settling = true;
+                    }
+                }
+                seen[key] = current;
+            }
+            // Files that went away (imported and removed) may come back as new ones
+            files.swap(seen);
+            baseline = false;
+        }
+
+        changed = m_backend->wait(settling ? SETTLE_POLL : IDLE_POLL);
+        // Keep rescanning while something is settling even if no new event came in
+        if (settling) {
+            changed = true;
+        }
+    }
+}
@@ -2,34 +2,24 @@
 #include "MasterData.h"
 #include "Config.h"
 #include "SessionState.h"
+#include "ArtworkPipeline.h"
+#include "JobWorker.h"
+#include "FolderWatcher.h"
+#include "AppPaths.h"
 #include <windows.h>
 #include <commdlg.h>
 #include <string>
 #include <sstream>
 #include <commctrl.h>
 #include <filesystem>
+#include <memory>
+#include <deque>
 
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(lib, "comdlg32.lib")
 
 namespace fs = std::filesystem;
 
-// Get the directory where the executable is located
-static std::string getExeDirectory() {
-    char buffer[MAX_PATH];
-    GetModuleFileNameA(NULL, buffer, MAX_PATH);
-    std::string exePath(buffer);
-    size_t pos = exePath.find_last_of("\\/");
-    return (pos != std::string::npos) ? exePath.substr(0, pos) : ".";
-}
-
-// Get absolute path for a relative path from exe directory
-static std::string getAbsolutePath(const std::string& relativePath) {
-    static std::string exeDir = getExeDirectory();
-    fs::path absPath = fs::path(exeDir) / relativePath;
-    return absPath.string();
-}
-
 // Button control IDs
 #define ID_BTN_LOAD_CSV          1001
 #define ID_BTN_GENERATE_BARCODE  1002
@@ -169,9 +159,95 @@ static HWND g_hStatusStep2 = NULL;
 static HWND g_hStatusStep3 = NULL;
 
 // Status state flags
-static bool g_step1Complete = false;
-static bool g_step2Complete = false;
-static bool g_step3Complete = false;
+static bool g_step1Complete = false;  // Panel saved to the master ledger
+static bool g_step2Complete = false;  // Laser files generated
+static bool g_step3Complete = false;  // Input CSV archived
+
+// Messages posted by background jobs back to the window
+#define WM_APP_JOB_PROGRESS  (WM_APP + 1)   // wParam = pipeline step (1-3) that just completed
+#define WM_APP_JOB_DONE      (WM_APP + 2)   // lParam = JobResult*, deleted by the window
+#define WM_APP_FILE_ARRIVED  (WM_APP + 3)   // lParam = std::string* path from the watcher, deleted by the window
+
+// Kinds of background job; only one runs at a time
+enum JobKind {
+    JOB_NONE,
+    JOB_LOAD_CSV,
+    JOB_GENERATE_ART,
+    JOB_EXPORT_HISTORY
+};
+
+// What a background job hands back to the UI thread
+struct JobResult {
+    JobKind kind;
+    bool ok;
+    Panel panel;                               // JOB_LOAD_CSV: the panel to show
+    LedgerError ledgerError;                   // JOB_LOAD_CSV: why saving failed
+    std::vector<SerialDuplicate> duplicates;   // JOB_LOAD_CSV: serials already used
+    ArtworkResult art;                         // JOB_GENERATE_ART: files written
+    std::string sourcePath;                    // JOB_LOAD_CSV: the CSV that was loaded
+};
+
+// Background worker for disk and network I/O, owned by runPanelViewerGui
+static JobWorker* g_jobWorker = NULL;
+static JobKind g_activeJob = JOB_NONE;
+
+// CSVs the input folder watcher reported while another job was running
+static std::deque<std::string> g_arrivedFiles;
+
+// Repaint the window and its owner-drawn buttons
+static void refreshWindow(HWND hwnd) {
+    RedrawWindow(hwnd, NULL, NULL, RDW_INVALIDATE | RDW_ERASE | RDW_ALLCHILDREN);
+}
+
+// Run work on the background worker and post its result back to the window
+static void startJob(HWND hwnd, JobKind kind, std::function<void(JobResult&)> work) {
+    g_activeJob = kind;
+    refreshWindow(hwnd);
+    g_jobWorker->post([hwnd, kind, work]() {
+        JobResult* result = new JobResult();
+        result->kind = kind;
+        result->ok = false;
+        result->ledgerError = LedgerError::None;
+        work(*result);
+        // If the window is already gone nobody will free the result
+        if (!PostMessage(hwnd, WM_APP_JOB_DONE, 0, (LPARAM)result)) {
+            delete result;
+        }
+    });
+}
+
+// Parse, save and archive a CSV on the worker; progress lights the pipeline steps.
+// Watched files are removed from InputPanels once archived so a restart does
+// not import them again.
+static void startLoadJob(HWND hwnd, const std::string& csvPath, bool removeSource) {
+    startJob(hwnd, JOB_LOAD_CSV, [hwnd, csvPath, removeSource](JobResult& result) {
+        result.sourcePath = csvPath;
+        PanelLoadReport report;
+        result.ok = loadPanelFromCsvFile(csvPath, result.panel, report, [hwnd](LoadStep step) {
+            if (step == LoadStep::Saved) {
+                PostMessage(hwnd, WM_APP_JOB_PROGRESS, 1, 0);
+            } else if (step == LoadStep::Archived) {
+                PostMessage(hwnd, WM_APP_JOB_PROGRESS, 3, 0);
+            }
+        });
+        result.ledgerError = report.ledgerError;
+        result.duplicates = std::move(report.duplicates);
+        if (result.ok && removeSource) {
+            std::error_code ec;
+            fs::remove(csvPath, ec);
+        }
+    });
+}
+
+// Start the next watched CSV once nothing else is running
+static void startNextArrivedFile(HWND hwnd) {
+    if (g_activeJob != JOB_NONE || g_arrivedFiles.empty()) {
+        return;
+    }
+    std::string csvPath = g_arrivedFiles.front();
+    g_arrivedFiles.pop_front();
+    startLoadJob(hwnd, csvPath, true);
+}
 
 // Window procedure callback
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
@@ -196,6 +272,10 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             if (btnID == ID_BTN_GENERATE_BARCODE || btnID == ID_BTN_OPEN_FOLDER) {
                 isEnabled = !g_panel.panelID.empty();
             }
+            // Actions that start a job wait for the running one to finish
+            if (g_activeJob != JOB_NONE && btnID != ID_BTN_OPEN_FOLDER) {
+                isEnabled = false;
+            }
             
             COLORREF bgColor, borderColor, textColor, iconColor;
             
@@ -341,6 +421,9 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     }
     case WM_COMMAND: {
         int controlId = LOWORD(wParam);
+        if (g_activeJob != JOB_NONE && controlId != ID_BTN_OPEN_FOLDER) {
+            return 0; // Busy; the buttons are drawn disabled
+        }
         switch (controlId) {
         case ID_BTN_LOAD_CSV: {
             // Show file open dialog
@@ -355,23 +438,12 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             ofn.nFilterIndex = 1;
             ofn.lpstrFileTitle = NULL;
             ofn.nMaxFileTitle = 0;
-            std::string inputPanelsDir = getAbsolutePath(WolfTrackConfig::INPUT_PANELS_ROOT);
+            std::string inputPanelsDir = appPaths().inputPanels;
             ofn.lpstrInitialDir = inputPanelsDir.c_str();
             ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST;
             
             if (GetOpenFileNameA(&ofn)) {
-                // Load the panel from CSV
-                if (loadPanelFromCsvFile(szFile, g_panel)) {
-                    // Update status flags
-                    g_step1Complete = true;
-                    g_step2Complete = true; // Laser files generated during load
-                    g_step3Complete = true; // Panel archived and logged during load
-                    
-                    // Repaint entire window to show updated pipeline and panel data
-                    InvalidateRect(hwnd, NULL, TRUE);
-                } else {
-                    MessageBoxA(hwnd, "Failed to load panel CSV. Please check the file format.", "Error", MB_OK | MB_ICONERROR);
-                }
+                startLoadJob(hwnd, szFile, false);
             }
             break;
         }
@@ -406,7 +478,7 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             }
             
             // STAGE 1 UPGRADE: Check if panel folder already exists
-            std::string pendingRoot = getAbsolutePath(WolfTrackConfig::PENDING_ART_ROOT);
+            std::string pendingRoot = appPaths().pendingArt;
             fs::path panelFolder = fs::path(pendingRoot) / g_panel.panelID;
             
             if (fs::exists(panelFolder) && fs::is_directory(panelFolder)) {
@@ -420,17 +492,18 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 }
             }
             
-            std::string artPath = createPanelArtSvg(g_panel);
-            std::string codePath = createPanelBarcodeSvgPlaceholder(g_panel);
-            
-            if (!artPath.empty() && !codePath.empty()) {
-                // No popup - status indicators already updated during CSV load
-            } else {
-                std::string msg = "Failed to generate SVG files.\\n";
-                if (artPath.empty()) msg += "Panel artwork failed.\\n";
-                if (codePath.empty()) msg += "DataMatrix label failed.";
-                MessageBoxA(hwnd, msg.c_str(), "Error", MB_OK | MB_ICONERROR);
-            }
+            // Both files are rendered and written by the artwork pipeline on the worker
+            Panel panel = g_panel;
+            std::string op = g_currentOperator;
+            startJob(hwnd, JOB_GENERATE_ART, [panel, op](JobResult& result) {
+                result.art = generateArtworkForPanels({panel}, op).front();
+                result.ok = result.art.ok;
+                // Laser files in PendingArt mean the panel can go on the laser;
+                // regenerating for a panel already past that leaves it alone
+                if (result.ok) {
+                    setPanelStatus(panel.panelID, PanelStatus::ReadyForLaser);
+                }
+            });
             break;
         }
         case ID_BTN_OPEN_FOLDER: {
@@ -448,18 +521,98 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             break;
         }
         case ID_BTN_VIEW_HISTORY: {
-            // Ensure the master CSV file exists before trying to open it
-            ensureMasterCsvExists();
-            
+            // Regenerate the master CSV view from the journal on the worker; it is
+            // opened when the job completes
+            startJob(hwnd, JOB_EXPORT_HISTORY, [](JobResult& result) {
+                result.ok = exportMasterCsv();
+            });
+            break;
+        }
+        }
+        return 0;
+    }
+    case WM_APP_JOB_PROGRESS: {
+        if (wParam == 1) {
+            // A new panel is in the ledger; its laser files and archive are still to come
+            g_step1Complete = true;
+            g_step2Complete = false;
+            g_step3Complete = false;
+        } else if (wParam == 3) {
+            g_step3Complete = true;
+        }
+        InvalidateRect(hwnd, NULL, TRUE);
+        return 0;
+    }
+    case WM_APP_JOB_DONE: {
+        std::unique_ptr<JobResult> result((JobResult*)lParam);
+        g_activeJob = JOB_NONE;
+        refreshWindow(hwnd);
+
+        switch (result->kind) {
+        case JOB_LOAD_CSV:
+            if (result->ok) {
+                g_panel = result->panel;
+                refreshWindow(hwnd);
+
+                // Duplicates are only flagged when the config allows them through
+                if (!result->duplicates.empty()) {
+                    std::string msg = "The panel was imported, but some PCB serials were already used:\n\n"
+                                      + formatDuplicateSerials(result->duplicates);
+                    MessageBoxA(hwnd, msg.c_str(), "Duplicate Serials", MB_OK | MB_ICONWARNING);
+                }
+            } else if (!result->duplicates.empty()) {
+                std::string msg = "The panel was not imported because some PCB serials were already used:\n\n"
+                                  + formatDuplicateSerials(result->duplicates);
+                MessageBoxA(hwnd, msg.c_str(), "Duplicate Serials", MB_OK | MB_ICONERROR);
+            } else if (result->ledgerError != LedgerError::None) {
+                std::string msg = "The panel could not be saved to the master ledger.\n\n" + ledgerErrorToString(result->ledgerError);
+                MessageBoxA(hwnd, msg.c_str(), "Error", MB_OK | MB_ICONERROR);
+            } else {
+                std::string msg = "Failed to load panel CSV. Please check the file format.\n\n"
+                                  + fs::path(result->sourcePath).filename().string();
+                MessageBoxA(hwnd, msg.c_str(), "Error", MB_OK | MB_ICONERROR);
+            }
+            break;
+        case JOB_GENERATE_ART:
+            if (result->ok) {
+                g_step2Complete = true;
+                refreshWindow(hwnd);
+            } else if (result->art.alreadyLasered) {
+                MessageBoxA(hwnd, "This panel has already been lasered. Its artwork is in CompletedArt and was left as it is.",
+                            "WolfTrack", MB_OK | MB_ICONINFORMATION);
+            } else {
+                std::string msg = "Failed to generate SVG files.\n";
+                if (result->art.artPath.empty()) msg += "Panel artwork failed.\n";
+                if (result->art.labelPath.empty()) msg += "DataMatrix label failed.";
+                MessageBoxA(hwnd, msg.c_str(), "Error", MB_OK | MB_ICONERROR);
+            }
+            break;
+        case JOB_EXPORT_HISTORY: {
+            if (!result->ok) {
+                MessageBoxA(hwnd, "Failed to update the history file. Close it in Excel and try again.", "Error", MB_OK | MB_ICONERROR);
+                break;
+            }
+
             // Open the master CSV history file using absolute path
-            std::string histPath = getAbsolutePath("MasterData\\wolftrack_panels_master.csv");
-            HINSTANCE result = ShellExecuteA(hwnd, "open", histPath.c_str(), nullptr, nullptr, SW_SHOWNORMAL);
-            if ((INT_PTR)result <= 32) {
+            std::string histPath = appPaths().masterCsv;
+            HINSTANCE opened = ShellExecuteA(hwnd, "open", histPath.c_str(), nullptr, nullptr, SW_SHOWNORMAL);
+            if ((INT_PTR)opened <= 32) {
                 MessageBoxA(hwnd, "Failed to open history file. Make sure it exists.", "Error", MB_OK | MB_ICONERROR);
             }
             break;
         }
+        default:
+            break;
         }
+
+        // Files dropped while this job ran (or while its message box was up)
+        startNextArrivedFile(hwnd);
+        return 0;
+    }
+    case WM_APP_FILE_ARRIVED: {
+        std::unique_ptr<std::string> path((std::string*)lParam);
+        g_arrivedFiles.push_back(*path);
+        startNextArrivedFile(hwnd);
         return 0;
     }
     case WM_PAINT: {
@@ -716,6 +869,54 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             DeleteObject(hPosFont);
         }
         
+        // === BOTTOM PROGRESS PIPELINE (driven by background job state) ===
+        RECT statusRect = {0, clientHeight - STATUS_HEIGHT, clientWidth, clientHeight};
+        HBRUSH hStatusBrush = CreateSolidBrush(COLOR_WHITE);
+        FillRect(hdc, &statusRect, hStatusBrush);
+        DeleteObject(hStatusBrush);
+        
+        HPEN hStatusPen = CreatePen(PS_SOLID, 1, COLOR_SLATE_200);
+        hOldPen = (HPEN)SelectObject(hdc, hStatusPen);
+        MoveToEx(hdc, 0, statusRect.top, NULL);
+        LineTo(hdc, clientWidth, statusRect.top);
+        SelectObject(hdc, hOldPen);
+        DeleteObject(hStatusPen);
+        
+        HFONT hStepFont = CreateFont(14, 0, 0, 0, FW_SEMIBOLD, FALSE, FALSE, FALSE,
+            DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
+            CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, TEXT("Segoe UI"));
+        SelectObject(hdc, hStepFont);
+        
+        const char* stepLabels[3] = {"1  Saved to ledger", "2  Laser files", "3  Archived"};
+        bool stepDone[3] = {g_step1Complete, g_step2Complete, g_step3Complete};
+        bool stepRunning[3] = {
+            g_activeJob == JOB_LOAD_CSV && !g_step1Complete,
+            g_activeJob == JOB_GENERATE_ART,
+            g_activeJob == JOB_LOAD_CSV && !g_step3Complete
+        };
+        int stepWidth = 200;
+        int stepX = 24;
+        int stepY = statusRect.top + (STATUS_HEIGHT - 16) / 2;
+        for (int i = 0; i < 3; ++i) {
+            // Green when done, blue while the job is working on it, grey otherwise
+            COLORREF dotColor = stepDone[i] ? COLOR_EMERALD_500
+                              : stepRunning[i] ? COLOR_SKY_600 : COLOR_SLATE_300;
+            HBRUSH hDotBrush = CreateSolidBrush(dotColor);
+            HPEN hDotPen = CreatePen(PS_SOLID, 1, dotColor);
+            HBRUSH hOldDotBrush = (HBRUSH)SelectObject(hdc, hDotBrush);
+            HPEN hOldDotPen = (HPEN)SelectObject(hdc, hDotPen);
+            Ellipse(hdc, stepX, stepY + 2, stepX + 12, stepY + 14);
+            SelectObject(hdc, hOldDotBrush);
+            SelectObject(hdc, hOldDotPen);
+            DeleteObject(hDotPen);
+            DeleteObject(hDotBrush);
+            
+            SetTextColor(hdc, stepDone[i] || stepRunning[i] ? COLOR_SLATE_700 : COLOR_SLATE_400);
+            TextOutA(hdc, stepX + 20, stepY, stepLabels[i], (int)strlen(stepLabels[i]));
+            stepX += stepWidth;
+        }
+        DeleteObject(hStepFont);
+
 
         SelectObject(hdc, hOldFont);
         EndPaint(hwnd, &ps);
@@ -856,10 +1057,33 @@ void runPanelViewerGui(const Panel& panel) {
     ShowWindow(hwnd, SW_SHOW);
     UpdateWindow(hwnd);
 
+    // Background worker for loads, artwork and exports; lives as long as the window
+    JobWorker jobWorker;
+    g_jobWorker = &jobWorker;
+
+    // New CSVs dropped into InputPanels by the MES are loaded as soon as they are complete
+    std::unique_ptr<FolderWatcher> inputWatcher;
+    if (WolfTrackConfig::WATCH_INPUT_PANELS) {
+        std::string inputDir = appPaths().inputPanels;
+        inputWatcher = std::make_unique<FolderWatcher>(inputDir, [hwnd](const std::string& path) {
+            std::string* arrived = new std::string(path);
+            if (!PostMessage(hwnd, WM_APP_FILE_ARRIVED, 0, (LPARAM)arrived)) {
+                delete arrived;
+            }
+        }, WatchBackendKind::Auto, std::chrono::milliseconds(WolfTrackConfig::WATCH_SETTLE_MS));
+    }
+
     // Run the message loop
     MSG msg = {};
     while (GetMessage(&msg, NULL, 0, 0)) {
         TranslateMessage(&msg);
         DispatchMessage(&msg);
     }
+
+    // Let a job that is mid-write finish before the process exits
+    if (inputWatcher) {
+        inputWatcher->stop();
+    }
+    jobWorker.stop();
+    g_jobWorker = NULL;
 }
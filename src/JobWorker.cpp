@@ -0,0 +1,59 @@
+#include "JobWorker.h"
+
+JobWorker::JobWorker() {
+    m_thread = std::thread(&JobWorker::run, this);
+}
+
+JobWorker::~JobWorker() {
+    stop();
+}
+
+void JobWorker::post(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        m_jobs.push_back(std::move(job));
+    }
+    m_wake.notify_one();
+}
+
+bool JobWorker::busy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_running || !m_jobs.empty();
+}
+
+void JobWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void JobWorker::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+        if (m_jobs.empty()) {
+            return; // Stopping with nothing left to do
+        }
+        std::function<void()> job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_running = true;
+        lock.unlock();
+
+        // A failing job must not take the worker (and every later job) down
+        try {
+            job();
+        } catch (...) {
+        }
+
+        lock.lock();
+        m_running = false;
+    }
+}
@@ -0,0 +1,166 @@
+#include "LaserJob.h"
+#include "AppPaths.h"
+#include "Config.h"
+#include "DataMatrix.h"
+#include "MasterData.h"
+#include "SvgWriter.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+
+namespace fs = std::filesystem;
+
+LaserBed configuredLaserBed() {
+    LaserBed bed;
+    bed.width = WolfTrackConfig::LASER_BED_WIDTH;
+    bed.height = WolfTrackConfig::LASER_BED_HEIGHT;
+    bed.margin = WolfTrackConfig::LASER_BED_MARGIN;
+    bed.spacing = WolfTrackConfig::LASER_JOB_SPACING;
+    return bed;
+}
+
+std::vector<LaserJobPlacement> nestLaserJob(const std::vector<int>& widths, const std::vector<int>& heights,
+                                            const LaserBed& bed) {
+    std::vector<LaserJobPlacement> placements(widths.size(), LaserJobPlacement{-1, 0, 0});
+    int usableWidth = bed.width - 2 * bed.margin;
+    int usableHeight = bed.height - 2 * bed.margin;
+
+    // Tallest first keeps each shelf close to the height of its items; ties keep input order
+    std::vector<size_t> order(widths.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&heights](size_t a, size_t b) {
+        return heights[a] > heights[b];
+    });
+
+    int sheet = -1;
+    int shelfY = 0;       // Top of the current shelf
+    int shelfHeight = 0;  // Tallest item on it
+    int cursorX = 0;      // Left edge of the next item on it
+    for (size_t i : order) {
+        if (widths[i] > usableWidth || heights[i] > usableHeight) {
+            continue;
+        }
+        if (sheet >= 0 && cursorX > 0 && cursorX + widths[i] > usableWidth) {
+            // Next shelf down
+            shelfY += shelfHeight + bed.spacing;
+            shelfHeight = 0;
+            cursorX = 0;
+        }
+        if (sheet < 0 || shelfY + heights[i] > usableHeight) {
+            sheet++;
+            shelfY = 0;
+            shelfHeight = 0;
+            cursorX = 0;
+        }
+        placements[i] = LaserJobPlacement{sheet, bed.margin + cursorX, bed.margin + shelfY};
+        cursorX += widths[i] + bed.spacing;
+        shelfHeight = (std::max)(shelfHeight, heights[i]);
+    }
+    return placements;
+}
+
+// A panel ready to be placed: its label symbol and the size of art + label
+struct JobItem {
+    const Panel* panel;
+    DataMatrixSymbol symbol;
+    int labelWidth;
+    int labelHeight;
+    int width;
+    int height;
+};
+
+LaserJobResult buildLaserJob(const std::vector<Panel>& panels, const std::string& operatorName,
+                             const LaserBed& bed, const std::string& outputDir, const std::string& jobName) {
+    LaserJobResult result;
+
+    // Art on the left, label to its right, tops aligned
+    std::vector<JobItem> items;
+    std::vector<int> widths;
+    std::vector<int> heights;
+    for (const Panel& panel : panels) {
+        JobItem item;
+        item.panel = &panel;
+        if (!encodeDataMatrix(dataMatrixPayload(panel), item.symbol)) {
+            result.skippedPanels.push_back(panel.panelID);
+            continue;
+        }
+        dataMatrixLabelSize(item.symbol, item.labelWidth, item.labelHeight);
+        item.width = PANEL_ART_WIDTH + bed.spacing + item.labelWidth;
+        item.height = (std::max)(PANEL_ART_HEIGHT, item.labelHeight);
+        widths.push_back(item.width);
+        heights.push_back(item.height);
+        items.push_back(std::move(item));
+    }
+
+    std::vector<LaserJobPlacement> placements = nestLaserJob(widths, heights, bed);
+    int sheets = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (placements[i].sheet < 0) {
+            result.skippedPanels.push_back(items[i].panel->panelID);
+        }
+        sheets = (std::max)(sheets, placements[i].sheet + 1);
+    }
+    if (sheets == 0 || !ensureDirectory(outputDir)) {
+        return result;
+    }
+
+    // One writer for every sheet; each sheet is written with a single call
+    SvgWriter svg(256 * 1024);
+    for (int sheet = 0; sheet < sheets; ++sheet) {
+        svg.clear();
+        svg.raw("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        svg.raw("<svg width=\"").number(bed.width).raw("\" height=\"").number(bed.height)
+           .raw("\" xmlns=\"http://www.w3.org/2000/svg\">\n");
+        svg.raw("  <!-- AVO Invents Ltd - WolfTrack Laser Job ").text(jobName).raw(" sheet ")
+           .number(sheet + 1).raw(" of ").number(sheets).raw(" -->\n");
+
+        std::vector<std::string> placed;
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (placements[i].sheet != sheet) {
+                continue;
+            }
+            const JobItem& item = items[i];
+            const std::string& id = item.panel->panelID;
+            svg.raw("<g id=\"").text(id).raw("\" transform=\"translate(").number(placements[i].x)
+               .raw(" ").number(placements[i].y).raw(")\">\n");
+            svg.raw("<g id=\"").text(id).raw("-art\">\n");
+            writePanelArtBody(*item.panel, operatorName, svg);
+            svg.raw("</g>\n");
+            svg.raw("<g id=\"").text(id).raw("-label\" transform=\"translate(")
+               .number(PANEL_ART_WIDTH + bed.spacing).raw(" 0)\">\n");
+            writeDataMatrixLabelBody(*item.panel, item.symbol, operatorName, svg);
+            svg.raw("</g>\n</g>\n");
+            placed.push_back(id);
+        }
+        svg.raw("</svg>\n");
+
+        fs::path jobPath = fs::path(outputDir) / (jobName + "_sheet" + std::to_string(sheet + 1) + ".svg");
+        if (!svg.writeToFile(jobPath.string())) {
+            result.skippedPanels.insert(result.skippedPanels.end(), placed.begin(), placed.end());
+            continue;
+        }
+        result.jobPaths.push_back(jobPath.string());
+        result.placedPanels.insert(result.placedPanels.end(), placed.begin(), placed.end());
+    }
+    return result;
+}
+
+LaserJobResult buildReadyForLaserJob(const std::string& operatorName) {
+    std::vector<Panel> panels = findMasterPanels(panelsWithStatus(PanelStatus::ReadyForLaser));
+    if (panels.empty()) {
+        return LaserJobResult();
+    }
+
+    // "job_20260116_142503" from the current local time
+    std::string stamp = currentTimestamp();
+    std::string jobName = "job_";
+    for (char c : stamp) {
+        if (c >= '0' && c <= '9') {
+            jobName += c;
+        } else if (c == ' ') {
+            jobName += '_';
+        }
+    }
+    return buildLaserJob(panels, operatorName, configuredLaserBed(), appPaths().laserJobs, jobName);
+}
@@ -0,0 +1,265 @@
+#include "LedgerIndex.h"
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// In-memory copy of the last index we loaded or saved, so repeat calls skip the sidecar read.
+// Guarded by s_indexMutex since imports can commit from worker threads.
+static std::mutex s_indexMutex;
+static std::string s_cachedIndexPath;
+static LedgerIndex s_cachedIndex;
+
+// Appends folded in since the last sidecar write; saved every CHECKPOINT_INTERVAL records.
+// A sidecar that lags the journal is still valid, the next start simply scans the gap.
+static int s_uncheckpointedRows = 0;
+static const int CHECKPOINT_INTERVAL = 64;
+
+// Records read per block when scanning the journal
+static const size_t SCAN_BLOCK_RECORDS = 256;
+
+static LedgerIndex emptyIndex() {
+    LedgerIndex idx;
+    idx.highWaterId = 0;
+    idx.rowCount = 0;
+    idx.pcbCount = 0;
+    idx.closedRows = 0;
+    idx.lastRowOffset = 0;
+    idx.validatedOffset = 0;
+    idx.lastRowHash = 0;
+    return idx;
+}
+
+std::string formatPanelId(int number) {
+    std::ostringstream oss;
+    oss << "WT-P-" << std::setfill('0') << std::setw(5) << number;
+    return oss.str();
+}
+
+int parsePanelIdNumber(const std::string& field) {
+    // Take the first CSV field only and strip the Excel ="..." wrapper
+    std::string id = field.substr(0, field.find(','));
+    if (!id.empty() && id.front() == '=') {
+        id.erase(0, 1);
+    }
+    if (id.size() >= 2 && id.front() == '"' && id.back() == '"') {
+        id = id.substr(1, id.size() - 2);
+    }
+
+    // Expected format: "WT-P-XXXXX"
+    if (id.size() < 6 || id.compare(0, 5, "WT-P-") != 0) {
+        return 0;
+    }
+    try {
+        return std::stoi(id.substr(5));
+    } catch (...) {
+        return 0; // Skip invalid IDs
+    }
+}
+
+static bool readIndexFile(const std::string& indexPath, LedgerIndex& out) {
+    std::ifstream in(indexPath);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    LedgerIndex idx = emptyIndex();
+    bool versionOk = false;
+    std::string line;
+    try {
+        while (std::getline(in, line)) {
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) {
+                continue;
+            }
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+            if (key == "version") versionOk = (value == "4");
+            else if (key == "highWaterId") idx.highWaterId = std::stoi(value);
+            else if (key == "rowCount") idx.rowCount = std::stoll(value);
+            else if (key == "pcbCount") idx.pcbCount = std::stoll(value);
+            else if (key == "closedRows") idx.closedRows = std::stoll(value);
+            else if (key == "lastRowOffset") idx.lastRowOffset = std::stoll(value);
+            else if (key == "validatedOffset") idx.validatedOffset = std::stoll(value);
+            else if (key == "lastRowHash") idx.lastRowHash = std::stoull(value);
+        }
+    } catch (...) {
+        return false; // Corrupt sidecar, caller rebuilds
+    }
+
+    if (!versionOk || idx.validatedOffset < 0) {
+        return false;
+    }
+    out = idx;
+    return true;
+}
+
+static void writeIndexFile(const std::string& indexPath, const LedgerIndex& idx) {
+    // Write to a temp file and rename so a crash never leaves a half-written index
+    std::string tmpPath = indexPath + ".tmp";
+    std::ofstream out(tmpPath, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        return;
+    }
+    out << "version=4\n";
+    out << "highWaterId=" << idx.highWaterId << "\n";
+    out << "rowCount=" << idx.rowCount << "\n";
+    out << "pcbCount=" << idx.pcbCount << "\n";
+    out << "closedRows=" << idx.closedRows << "\n";
+    out << "lastRowOffset=" << idx.lastRowOffset << "\n";
+    out << "validatedOffset=" << idx.validatedOffset << "\n";
+    out << "lastRowHash=" << idx.lastRowHash << "\n";
+    out.close();
+
+    std::error_code ec;
+    fs::rename(tmpPath, indexPath, ec);
+}
+
+// Fold one valid journal record into the running totals. A record that is
+// also in a closed segment is already counted there; only step past it.
+static void accountRecord(LedgerIndex& idx, const PanelJournalRecord& record, long long offset) {
+    if (static_cast<long long>(record.sequence) >= idx.closedRows) {
+        idx.rowCount++;
+        for (const auto& serial : record.pcbSerials) {
+            if (serial[0] != '\0') {
+                idx.pcbCount++;
+            }
+        }
+    }
+    int num = parsePanelIdNumber(std::string(record.panelID, strnlen(record.panelID, sizeof(record.panelID))));
+    if (num > idx.highWaterId) {
+        idx.highWaterId = num;
+    }
+
+    idx.lastRowOffset = offset;
+    idx.validatedOffset = offset + static_cast<long long>(sizeof(PanelJournalRecord));
+    idx.lastRowHash = record.crc;
+}
+
+// Check the record noted as last validated is still where the index says it is
+static bool indexMatchesJournal(std::ifstream& in, long long journalSize, const LedgerIndex& idx) {
+    if (idx.validatedOffset > journalSize) {
+        return false;
+    }
+    if (idx.validatedOffset == 0) {
+        return true;
+    }
+    if (idx.validatedOffset != idx.lastRowOffset + static_cast<long long>(sizeof(PanelJournalRecord))) {
+        return false;
+    }
+
+    PanelJournalRecord record;
+    in.clear();
+    in.seekg(idx.lastRowOffset);
+    if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        return false;
+    }
+    return isValidJournalRecord(record) && record.crc == idx.lastRowHash;
+}
+
+// Scan whole records starting at idx.validatedOffset. A trailing partial or
+// corrupt record was torn by an interrupted write and is not counted.
+static void scanAppendedRecords(std::ifstream& in, LedgerIndex& idx) {
+    in.clear();
+    in.seekg(idx.validatedOffset);
+
+    std::vector<PanelJournalRecord> block(SCAN_BLOCK_RECORDS);
+    while (in) {
+        in.read(reinterpret_cast<char*>(block.data()),
+                static_cast<std::streamsize>(block.size() * sizeof(PanelJournalRecord)));
+        size_t whole = static_cast<size_t>(in.gcount()) / sizeof(PanelJournalRecord);
+        for (size_t i = 0; i < whole; ++i) {
+            if (!isValidJournalRecord(block[i])) {
+                return;
+            }
+            accountRecord(idx, block[i], idx.validatedOffset);
+        }
+    }
+}
+
+LedgerIndex refreshLedgerIndex(const std::string& journalPath, const std::string& indexPath,
+                               long long closedRows) {
+    std::lock_guard<std::mutex> lock(s_indexMutex);
+    LedgerIndex idx = emptyIndex();
+    bool haveIndex = false;
+    if (s_cachedIndexPath == indexPath) {
+        idx = s_cachedIndex;
+        haveIndex = true;
+    } else {
+        haveIndex = readIndexFile(indexPath, idx);
+    }
+
+    std::ifstream in(journalPath, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        return emptyIndex();
+    }
+
+    std::error_code ec;
+    long long journalSize = static_cast<long long>(fs::file_size(journalPath, ec));
+    if (ec) {
+        return emptyIndex();
+    }
+
+    // New segments change which journal records are counted
+    bool rebuild = !haveIndex || idx.closedRows != closedRows || !indexMatchesJournal(in, journalSize, idx);
+    if (rebuild) {
+        idx = emptyIndex();
+        idx.closedRows = closedRows;
+    }
+
+    LedgerIndex before = idx;
+    if (idx.validatedOffset < journalSize) {
+        scanAppendedRecords(in, idx);
+    }
+
+    if (rebuild || idx.validatedOffset != before.validatedOffset) {
+        writeIndexFile(indexPath, idx);
+        s_uncheckpointedRows = 0;
+    }
+
+    s_cachedIndexPath = indexPath;
+    s_cachedIndex = idx;
+    return idx;
+}
+
+void noteLedgerRecordsAppended(const std::string& indexPath, long long offset,
+                               const std::vector<PanelJournalRecord>& records) {
+    std::lock_guard<std::mutex> lock(s_indexMutex);
+    // Only valid if the records land exactly where the cached index stops
+    if (s_cachedIndexPath != indexPath || s_cachedIndex.validatedOffset != offset) {
+        return;
+    }
+
+    for (const PanelJournalRecord& record : records) {
+        accountRecord(s_cachedIndex, record, s_cachedIndex.validatedOffset);
+    }
+
+    s_uncheckpointedRows += static_cast<int>(records.size());
+    if (s_uncheckpointedRows >= CHECKPOINT_INTERVAL) {
+        writeIndexFile(s_cachedIndexPath, s_cachedIndex);
+        s_uncheckpointedRows = 0;
+    }
+}
+
+void checkpointLedgerIndex() {
+    std::lock_guard<std::mutex> lock(s_indexMutex);
+    if (s_cachedIndexPath.empty() || s_uncheckpointedRows == 0) {
+        return;
+    }
+    writeIndexFile(s_cachedIndexPath, s_cachedIndex);
+    s_uncheckpointedRows = 0;
+}
+
+void discardLedgerIndex(const std::string& indexPath) {
+    std::lock_guard<std::mutex> lock(s_indexMutex);
+    if (s_cachedIndexPath == indexPath) {
+        s_cachedIndexPath.clear();
+        s_uncheckpointedRows = 0;
+    }
+    std::error_code ec;
+    fs::remove(indexPath, ec);
+}
@@ -0,0 +1,327 @@
+#include "LedgerSegments.h"
+#include "Compression.h"
+#include "LedgerIndex.h"
+#include "LedgerWriter.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// Footers of the segments folder as last listed, reused until the folder changes
+static std::mutex s_segmentsMutex;
+static std::string s_cachedDir;
+static fs::file_time_type s_cachedDirTime;
+static std::vector<LedgerSegmentInfo> s_cachedSegments;
+
+// The folder changed; do not trust a cached listing that has the same timestamp
+static void forgetCachedSegments() {
+    std::lock_guard<std::mutex> lock(s_segmentsMutex);
+    s_cachedDir.clear();
+}
+
+static uint32_t footerCrc(const LedgerSegmentFooter& footer) {
+    return journalCrc32(&footer, offsetof(LedgerSegmentFooter, crc));
+}
+
+// "YYYY-MM" in local time, the unit segments are rolled by
+static std::string monthOf(long long epoch) {
+    return epochToTimestamp(epoch).substr(0, 7);
+}
+
+static bool readSegmentFooter(const fs::path& path, LedgerSegmentFooter& footer) {
+    std::error_code ec;
+    unsigned long long size = fs::file_size(path, ec);
+    if (ec || size < sizeof(footer)) {
+        return false;
+    }
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(size - sizeof(footer)));
+    if (!in.read(reinterpret_cast<char*>(&footer), sizeof(footer))) {
+        return false;
+    }
+    return footer.magic == SEGMENT_FOOTER_MAGIC && footer.version == 1 && footer.crc == footerCrc(footer) &&
+           footer.payloadSize + sizeof(footer) == size;
+}
+
+std::vector<LedgerSegmentInfo> listLedgerSegments(const std::string& segmentsDir) {
+    std::lock_guard<std::mutex> lock(s_segmentsMutex);
+    std::error_code ec;
+    fs::file_time_type dirTime = fs::last_write_time(segmentsDir, ec);
+    if (ec) {
+        return {};  // No segments folder: nothing has been rolled yet
+    }
+    if (s_cachedDir == segmentsDir && s_cachedDirTime == dirTime) {
+        return s_cachedSegments;
+    }
+
+    std::vector<LedgerSegmentInfo> segments;
+    for (const auto& item : fs::directory_iterator(segmentsDir, ec)) {
+        if (item.path().extension() != ".wts") {
+            continue;
+        }
+        LedgerSegmentInfo info;
+        if (!readSegmentFooter(item.path(), info.footer)) {
+            continue;
+        }
+        info.path = item.path().string();
+        // Names are ledger_YYYY-MM_NNNNNNNN.wts
+        std::string name = item.path().stem().string();
+        info.month = name.size() >= 14 ? name.substr(7, 7) : "";
+        segments.push_back(info);
+    }
+    std::sort(segments.begin(), segments.end(), [](const LedgerSegmentInfo& a, const LedgerSegmentInfo& b) {
+        return a.footer.firstRecord < b.footer.firstRecord;
+    });
+
+    s_cachedDir = segmentsDir;
+    s_cachedDirTime = dirTime;
+    s_cachedSegments = segments;
+    return segments;
+}
+
+LedgerSegmentTotals ledgerSegmentTotals(const std::string& segmentsDir) {
+    LedgerSegmentTotals totals = {0, 0, 0};
+    for (const LedgerSegmentInfo& segment : listLedgerSegments(segmentsDir)) {
+        totals.rowCount = segment.footer.firstRecord + segment.footer.rowCount;
+        totals.pcbCount += segment.footer.pcbCount;
+        totals.highWaterId = (std::max)(totals.highWaterId, static_cast<int>(segment.footer.maxPanelId));
+    }
+    return totals;
+}
+
+bool readLedgerSegment(const LedgerSegmentInfo& segment, std::vector<PanelJournalRecord>& records) {
+    try {
+        const LedgerSegmentFooter& footer = segment.footer;
+        std::string compressed(static_cast<size_t>(footer.payloadSize), '\0');
+        std::ifstream in(segment.path, std::ios::in | std::ios::binary);
+        if (!in.read(&compressed[0], static_cast<std::streamsize>(compressed.size()))) {
+            return false;
+        }
+
+        std::string raw;
+        if (!decompressBytes(compressed, raw) ||
+            raw.size() != static_cast<size_t>(footer.rowCount) * sizeof(PanelJournalRecord)) {
+            return false;
+        }
+        records.resize(static_cast<size_t>(footer.rowCount));
+        std::memcpy(records.data(), raw.data(), raw.size());
+
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (!isValidJournalRecord(records[i]) ||
+                records[i].sequence != static_cast<uint32_t>(footer.firstRecord + static_cast<long long>(i))) {
+                return false;
+            }
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+// Write records as a closed segment: compressed payload then footer, flushed
+// to disk under a temporary name and renamed into place
+static bool writeLedgerSegment(const std::string& segmentsDir, const std::string& month,
+                               const PanelJournalRecord* records, size_t count) {
+    LedgerSegmentFooter footer = {};
+    footer.magic = SEGMENT_FOOTER_MAGIC;
+    footer.version = 1;
+    footer.firstRecord = records[0].sequence;
+    footer.rowCount = static_cast<int64_t>(count);
+    footer.minCreatedAt = records[0].createdAt;
+    footer.maxCreatedAt = records[0].createdAt;
+    for (size_t i = 0; i < count; ++i) {
+        const PanelJournalRecord& record = records[i];
+        for (const auto& serial : record.pcbSerials) {
+            if (serial[0] != '\0') {
+                footer.pcbCount++;
+            }
+        }
+        int id = parsePanelIdNumber(std::string(record.panelID, strnlen(record.panelID, sizeof(record.panelID))));
+        if (id > 0) {
+            footer.minPanelId = footer.minPanelId == 0 ? id : (std::min)(footer.minPanelId, id);
+            footer.maxPanelId = (std::max)(footer.maxPanelId, id);
+        }
+        footer.minCreatedAt = (std::min)(footer.minCreatedAt, record.createdAt);
+        footer.maxCreatedAt = (std::max)(footer.maxCreatedAt, record.createdAt);
+    }
+
+    std::string file = compressBytes(std::string_view(reinterpret_cast<const char*>(records),
+                                                      count * sizeof(PanelJournalRecord)));
+    footer.payloadSize = file.size();
+    footer.crc = footerCrc(footer);
+    file.append(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+    std::ostringstream name;
+    name << "ledger_" << month << "_" << std::setfill('0') << std::setw(8) << footer.firstRecord << ".wts";
+    fs::path path = fs::path(segmentsDir) / name.str();
+    fs::path tmpPath = path;
+    tmpPath += ".tmp";
+
+    std::error_code ec;
+    fs::remove(tmpPath, ec);
+    if (appendDurably(tmpPath.string(), file.data(), file.size()) != LedgerError::None) {
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    fs::rename(tmpPath, path, ec);
+    return !ec;
+}
+
+long long rollLedgerSegments(const std::string& journalPath, const std::string& segmentsDir, long long nowEpoch) {
+    try {
+        long long closedRows = ledgerSegmentTotals(segmentsDir).rowCount;
+
+        std::vector<PanelJournalRecord> records;
+        replayPanelJournal(journalPath, [&records](const PanelJournalRecord& record, long long) {
+            records.push_back(record);
+        });
+
+        // Records an interrupted roll already wrote to a segment are simply dropped
+        size_t start = 0;
+        while (start < records.size() && static_cast<long long>(records[start].sequence) < closedRows) {
+            start++;
+        }
+        for (size_t i = start; i < records.size(); ++i) {
+            if (static_cast<long long>(records[i].sequence) != closedRows + static_cast<long long>(i - start)) {
+                return -1;  // Numbering does not follow on from the segments; leave it alone
+            }
+        }
+
+        // Cut one segment per run of records from the same month, stopping at
+        // the first record from the current month
+        std::string currentMonth = monthOf(nowEpoch);
+        fs::create_directories(segmentsDir);
+        size_t end = start;
+        size_t runStart = start;
+        std::string runMonth;
+        while (end < records.size()) {
+            std::string month = records[end].createdAt > 0 ? monthOf(records[end].createdAt)
+                                                           : (runMonth.empty() ? "0000-00" : runMonth);
+            if (month >= currentMonth) {
+                break;
+            }
+            if (month != runMonth && end > runStart) {
+                if (!writeLedgerSegment(segmentsDir, runMonth, &records[runStart], end - runStart)) {
+                    forgetCachedSegments();
+                    return -1;
+                }
+                runStart = end;
+            }
+            runMonth = month;
+            end++;
+        }
+        bool written = end == runStart ||
+                       writeLedgerSegment(segmentsDir, runMonth, &records[runStart], end - runStart);
+        if (end > start) {
+            forgetCachedSegments();
+        }
+        if (!written) {
+            return -1;
+        }
+        if (end == 0) {
+            return 0;
+        }
+
+        // Swap in a journal holding only the open month
+        std::string tmpPath = journalPath + ".roll";
+        std::error_code ec;
+        fs::remove(tmpPath, ec);
+        const char* rest = reinterpret_cast<const char*>(records.data() + end);
+        if (appendDurably(tmpPath, rest, (records.size() - end) * sizeof(PanelJournalRecord)) != LedgerError::None) {
+            fs::remove(tmpPath, ec);
+            return -1;
+        }
+        fs::rename(tmpPath, journalPath, ec);
+        if (ec) {
+            fs::remove(tmpPath, ec);
+            return -1;
+        }
+        return static_cast<long long>(end);
+    } catch (...) {
+        return -1;
+    }
+}
+
+// Visit journal records numbered from firstRecord on, skipping any an
+// interrupted roll left behind that also live in a segment
+static long long replayJournalFrom(const std::string& journalPath, long long closedRows, long long firstRecord,
+                                   const std::function<void(const PanelJournalRecord&, long long)>& visit) {
+    PanelJournalRecord first;
+    std::ifstream in(journalPath, std::ios::in | std::ios::binary);
+    if (!in.read(reinterpret_cast<char*>(&first), sizeof(first)) || !isValidJournalRecord(first)) {
+        return 0;
+    }
+    in.close();
+
+    long long journalBase = first.sequence;
+    long long from = (std::max)(firstRecord, closedRows);
+    if (from < journalBase) {
+        from = journalBase;
+    }
+    return replayPanelJournal(journalPath, [&visit, journalBase](const PanelJournalRecord& record, long long row) {
+        visit(record, journalBase + row);
+    }, from - journalBase);
+}
+
+long long replayLedger(const std::string& journalPath, const std::string& segmentsDir,
+                       const std::function<void(const PanelJournalRecord&, long long)>& visit,
+                       long long firstRecord) {
+    long long count = 0;
+    long long closedRows = 0;
+    std::vector<PanelJournalRecord> records;
+    for (const LedgerSegmentInfo& segment : listLedgerSegments(segmentsDir)) {
+        const LedgerSegmentFooter& footer = segment.footer;
+        closedRows = footer.firstRecord + footer.rowCount;
+        if (closedRows <= firstRecord) {
+            continue;
+        }
+        if (!readLedgerSegment(segment, records)) {
+            return count;  // Stop at damage, like a torn journal record
+        }
+        for (size_t i = 0; i < records.size(); ++i) {
+            long long row = footer.firstRecord + static_cast<long long>(i);
+            if (row >= firstRecord) {
+                visit(records[i], row);
+                count++;
+            }
+        }
+    }
+    return count + replayJournalFrom(journalPath, closedRows, firstRecord, visit);
+}
+
+long long replayLedgerTimeRange(const std::string& journalPath, const std::string& segmentsDir,
+                                long long fromEpoch, long long toEpoch,
+                                const std::function<void(const PanelJournalRecord&, long long)>& visit) {
+    long long count = 0;
+    long long closedRows = 0;
+    auto inRange = [&](const PanelJournalRecord& record, long long row) {
+        if (record.createdAt >= fromEpoch && record.createdAt <= toEpoch) {
+            visit(record, row);
+            count++;
+        }
+    };
+
+    std::vector<PanelJournalRecord> records;
+    for (const LedgerSegmentInfo& segment : listLedgerSegments(segmentsDir)) {
+        const LedgerSegmentFooter& footer = segment.footer;
+        closedRows = footer.firstRecord + footer.rowCount;
+        if (footer.maxCreatedAt < fromEpoch || footer.minCreatedAt > toEpoch) {
+            continue;
+        }
+        if (!readLedgerSegment(segment, records)) {
+            continue;
+        }
+        for (size_t i = 0; i < records.size(); ++i) {
+            inRange(records[i], footer.firstRecord + static_cast<long long>(i));
+        }
+    }
+    replayJournalFrom(journalPath, closedRows, 0, inRange);
+    return count;
+}
@@ -0,0 +1,199 @@
+#include "LedgerWriter.h"
+#include "Platform.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+std::string ledgerErrorToString(LedgerError error) {
+    switch (error) {
+        case LedgerError::None:          return "OK";
+        case LedgerError::InvalidRecord: return "A PanelID or PCB serial is too long to store in the ledger";
+        case LedgerError::OpenFailed:    return "The master ledger could not be opened for writing";
+        case LedgerError::WriteFailed:   return "Writing to the master ledger failed";
+        case LedgerError::SyncFailed:    return "The master ledger could not be flushed to disk";
+        case LedgerError::ShuttingDown:  return "The ledger writer was stopped before the panel was saved";
+        case LedgerError::NotMigrated:   return "The old master CSV has rows that do not fit the ledger; see the .rejected file next to it";
+        default:                         return "Unknown ledger error";
+    }
+}
+
+LedgerError appendDurably(const std::string& path, const char* data, size_t length) {
+    switch (appendFileDurably(path, data, length)) {
+        case FileWriteError::None:        return LedgerError::None;
+        case FileWriteError::OpenFailed:  return LedgerError::OpenFailed;
+        case FileWriteError::WriteFailed: return LedgerError::WriteFailed;
+        default:                          return LedgerError::SyncFailed;
+    }
+}
+
+std::string ledgerLockPath(const std::string& journalPath) {
+    return journalPath + ".lck";
+}
+
+LedgerWriter::LedgerWriter(const std::string& journalPath, std::chrono::milliseconds commitWindow,
+                           std::function<long long()> firstSequence)
+    : m_journalPath(journalPath), m_commitWindow(commitWindow), m_firstSequence(std::move(firstSequence)) {
+    // Whatever an earlier crash left half-written is dropped before we append;
+    // under the lock, so another station's write in progress is left alone
+    FileRangeLock lock(ledgerLockPath(m_journalPath), 0, 1);
+    m_needsRecovery = !lock.locked() || recoverJournalTail(m_journalPath) < 0;
+    m_thread = std::thread(&LedgerWriter::commitLoop, this);
+}
+
+LedgerWriter::~LedgerWriter() {
+    stop();
+}
+
+void LedgerWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+LedgerCommit LedgerWriter::append(const std::vector<Panel>& panels) {
+    LedgerCommit commit;
+    commit.error = LedgerError::None;
+    commit.offset = 0;
+    if (panels.empty()) {
+        return commit;
+    }
+
+    // Validate up front so a bad panel is reported before anything is queued;
+    // sequence numbers are assigned when the group is written
+    PendingAppend pending;
+    pending.records.resize(panels.size());
+    for (size_t i = 0; i < panels.size(); ++i) {
+        if (!panelToJournalRecord(panels[i], 0, pending.records[i])) {
+            commit.error = LedgerError::InvalidRecord;
+            return commit;
+        }
+    }
+
+    std::future<LedgerCommit> result = pending.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            commit.error = LedgerError::ShuttingDown;
+            return commit;
+        }
+        m_pending.push_back(std::move(pending));
+    }
+    m_wake.notify_all();
+    return result.get();
+}
+
+void LedgerWriter::commitLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_stopping || !m_pending.empty(); });
+        if (m_pending.empty()) {
+            return; // Stopping with nothing left to commit
+        }
+
+        // Hold the group open briefly so appends arriving together share one flush
+        if (!m_stopping) {
+            m_wake.wait_for(lock, m_commitWindow, [this]() { return m_stopping; });
+        }
+
+        std::vector<PendingAppend> group;
+        group.swap(m_pending);
+        lock.unlock();
+
+        std::vector<PanelJournalRecord> records;
+        for (PendingAppend& item : group) {
+            records.insert(records.end(), item.records.begin(), item.records.end());
+        }
+        long long offset = 0;
+        LedgerError error = writeGroup(records, offset);
+
+        // Hand each caller back its own slice of the group
+        size_t next = 0;
+        for (PendingAppend& item : group) {
+            LedgerCommit commit;
+            commit.error = error;
+            commit.offset = offset + static_cast<long long>(next * sizeof(PanelJournalRecord));
+            if (error == LedgerError::None) {
+                commit.records.assign(records.begin() + next, records.begin() + next + item.records.size());
+            }
+            next += item.records.size();
+            item.done.set_value(std::move(commit));
+        }
+
+        lock.lock();
+    }
+}
+
+// Size of the journal and its last record, if it has one. False if the
+// journal could not be read or ends in a torn record.
+static bool readJournalEnd(const std::string& journalPath, unsigned long long& size,
+                           PanelJournalRecord& last, bool& hasLast) {
+    // One stat: a missing journal is simply empty
+    std::error_code ec;
+    size = fs::file_size(journalPath, ec);
+    if (ec == std::errc::no_such_file_or_directory) {
+        size = 0;
+    } else if (ec) {
+        return false;
+    }
+    hasLast = size >= sizeof(PanelJournalRecord);
+    if (!hasLast) {
+        return true;
+    }
+    std::ifstream in(journalPath, std::ios::in | std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(size - sizeof(last)));
+    return in.read(reinterpret_cast<char*>(&last), sizeof(last)) && isValidJournalRecord(last);
+}
+
+LedgerError LedgerWriter::writeGroup(std::vector<PanelJournalRecord>& records, long long& offset) {
+    // Other stations may append to the same journal; the last record and the
+    // end of file only stay put while we hold the lock
+    FileRangeLock lock(ledgerLockPath(m_journalPath), 0, 1);
+    if (!lock.locked()) {
+        return LedgerError::OpenFailed;
+    }
+
+    // A failed earlier group may have left a partial record; repair before numbering
+    if (m_needsRecovery) {
+        if (recoverJournalTail(m_journalPath) < 0) {
+            return LedgerError::OpenFailed;
+        }
+        m_needsRecovery = false;
+    }
+
+    unsigned long long size = 0;
+    PanelJournalRecord last;
+    bool hasLast = false;
+    if (!readJournalEnd(m_journalPath, size, last, hasLast)) {
+        // Another station crashed mid-append; we hold the lock, so its torn
+        // record can be dropped now instead of failing this group
+        if (recoverJournalTail(m_journalPath) < 0 || !readJournalEnd(m_journalPath, size, last, hasLast)) {
+            m_needsRecovery = true;
+            return LedgerError::OpenFailed;
+        }
+    }
+
+    offset = static_cast<long long>(size);
+    uint32_t sequence = 0;
+    if (hasLast) {
+        // Continue from the last record; earlier ones may have been rolled into segments
+        sequence = last.sequence + 1;
+    } else if (m_firstSequence) {
+        sequence = static_cast<uint32_t>(m_firstSequence());
+    }
+    for (PanelJournalRecord& record : records) {
+        setJournalRecordSequence(record, sequence++);
+    }
+
+    LedgerError error = appendDurably(m_journalPath, reinterpret_cast<const char*>(records.data()),
+                                      records.size() * sizeof(PanelJournalRecord));
+    if (error != LedgerError::None) {
+        m_needsRecovery = true;
+    }
+    return error;
+}
@@ -1,483 +1,1134 @@
 #include "MasterData.h"
+#include "LedgerIndex.h"
 #include "Config.h"
 #include "SessionState.h"
+#include "PanelCsvReader.h"
+#include "PanelJournal.h"
+#include "Timestamp.h"
+#include "LedgerWriter.h"
+#include "SerialIndex.h"
+#include "DataMatrix.h"
+#include "ContentArchive.h"
+#include "LedgerSegments.h"
+#include "PanelSearch.h"
+#include "Metrics.h"
+#include "Platform.h"
+#include "AppPaths.h"
+#include "PanelIdReservation.h"
+#include "PendingArtQueue.h"
+#include "PanelMetadata.h"
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <filesystem>
-#include <chrono>
-#include <iomanip>
+#include <future>
+#include <mutex>
 #include <sstream>
-#include <windows.h>
+#include <vector>
 
 namespace fs = std::filesystem;
 
-// Get the directory where the executable is located
-static std::string getExeDirectory() {
-    char buffer[MAX_PATH];
-    GetModuleFileNameA(NULL, buffer, MAX_PATH);
-    std::string exePath(buffer);
-    size_t pos = exePath.find_last_of("\\/");
-    return (pos != std::string::npos) ? exePath.substr(0, pos) : ".";
-}
-
-// Get absolute path for a relative path from exe directory
-static std::string getAbsolutePath(const std::string& relativePath) {
-    static std::string exeDir = getExeDirectory();
-    fs::path absPath = fs::path(exeDir) / relativePath;
-    return absPath.string();
-}
-
-static std::string currentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &t);
-#else
-    tm = *std::localtime(&t);
-#endif
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+// Write the UTF-8 BOM and header row Excel users expect
+static void writeMasterCsvHeader(std::ostream& out) {
+    // Write UTF-8 BOM to help Excel recognize encoding
+    out << "\xEF\xBB\xBF";
+    out << "PanelID";
+    for (int i = 1; i <= 24; ++i) {
+        out << ",PCB" << i;
+    }
+    out << ",Operator,CreatedAt,Status,SourceFile\n";
 }
 
 void ensureMasterCsvExists() {
-    // Get absolute paths
-    std::string masterDir = getAbsolutePath("MasterData");
-    std::string masterCsvPath = getAbsolutePath(MASTER_CSV_PATH);
+    const AppPaths& paths = appPaths();
     
     // Create MasterData directory if it doesn't exist
-    fs::create_directories(masterDir);
+    ensureDirectory(paths.masterDir);
     
-    if (!fs::exists(masterCsvPath)) {
-        std::ofstream out(masterCsvPath, std::ios::out | std::ios::binary);
-        // Write UTF-8 BOM to help Excel recognize encoding
-        out << "\xEF\xBB\xBF";
-        out << "PanelID";
-        for (int i = 1; i <= 24; ++i) {
-            out << ",PCB" << i;
-        }
-        out << ",Operator,CreatedAt,Status,SourceFile\n";
+    if (!fs::exists(paths.masterCsv)) {
+        std::ofstream out(paths.masterCsv, std::ios::out | std::ios::binary);
+        writeMasterCsvHeader(out);
         out.close();
     }
 }
 
-std::string generateNextPanelID() {
-    ensureMasterCsvExists();
+// Split one master CSV row of ="value" fields back into a Panel
+static bool parseMasterRow(const std::string& line, Panel& out) {
+    std::vector<std::string> fields;
+    size_t pos = 0;
+    while (pos <= line.size()) {
+        std::string field;
+        if (line.compare(pos, 2, "=\"") == 0) {
+            // Quoted field: runs to the closing quote before the next comma
+            size_t close = line.find("\",", pos + 2);
+            if (close == std::string::npos) {
+                close = line.rfind('"');
+            }
+            if (close == std::string::npos || close < pos + 2) {
+                return false;
+            }
+            field = line.substr(pos + 2, close - pos - 2);
+            pos = close + 2;
+        } else {
+            size_t comma = line.find(',', pos);
+            field = line.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+            pos = (comma == std::string::npos) ? line.size() + 1 : comma + 1;
+        }
+        fields.push_back(field);
+    }
 
-    std::string masterCsvPath = getAbsolutePath(MASTER_CSV_PATH);
-    std::ifstream in(masterCsvPath);
-    if (!in.is_open()) {
-        return "WT-P-00001";
+    if (fields.size() < 29) {
+        return false;
     }
+    out.panelID = fields[0];
+    out.panelNumber = fields[0];
+    for (size_t i = 0; i < 24; ++i) {
+        out.pcbSerials[i] = fields[i + 1];
+    }
+    out.operatorName = fields[25];
+    out.createdAt = fields[26];
+    out.status = panelStatusFromString(fields[27]);
+    out.sourceFile = fields[28];
+    out.laseredAt = "";
+    return true;
+}
 
-    std::string line;
-    int maxNum = 0;
-    bool foundHeader = false;
-    
-    while (std::getline(in, line)) {
-        if (!foundHeader) {
-            foundHeader = true;
-            continue; // Skip header row
+// Roll finished months out of the journal into closed segments and return the
+// journal path. Runs once, before this process's writer exists; the journal
+// lock keeps other stations from appending while the journal is swapped.
+static std::string rollMasterSegments() {
+    std::string journalPath = appPaths().masterJournal;
+    FileRangeLock lock(ledgerLockPath(journalPath), 0, 1);
+    if (!lock.locked()) {
+        return journalPath;
+    }
+    recoverJournalTail(journalPath);
+    long long now = timestampToEpoch(currentTimestamp());
+    if (rollLedgerSegments(journalPath, appPaths().segmentsDir, now) > 0) {
+        discardLedgerIndex(appPaths().masterIndex);
+    }
+    return journalPath;
+}
+
+// Records in closed segments, i.e. the number the journal's first record gets
+static long long closedSegmentRows() {
+    return ledgerSegmentTotals(appPaths().segmentsDir).rowCount;
+}
+
+// Single durable writer for the master journal, created on first use
+static LedgerWriter& masterLedgerWriter() {
+    static LedgerWriter writer(rollMasterSegments(), std::chrono::milliseconds(20), closedSegmentRows);
+    return writer;
+}
+
+// One-time migration: ledgers from before the journal only have the CSV.
+// Every row must fit a journal record; if any does not, nothing is migrated,
+// the rejected rows are listed in <csv>.rejected and the CSV stays the ledger.
+// The caller holds the journal lock, so only one station migrates.
+static bool migrateMasterCsvToJournal(const std::string& journalPath) {
+    std::vector<PanelJournalRecord> records;
+    std::string rejected;
+    std::string masterCsvPath = appPaths().masterCsv;
+    std::ifstream in(masterCsvPath, std::ios::in | std::ios::binary);
+    if (in.is_open()) {
+        // Keep a copy, since the CSV is regenerated from the journal from now on
+        std::error_code ec;
+        fs::copy_file(masterCsvPath, masterCsvPath + ".pre-journal", fs::copy_options::skip_existing, ec);
+
+        std::string line;
+        std::getline(in, line); // Skip header row
+        for (long long lineNumber = 2; std::getline(in, line); ++lineNumber) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+            Panel p;
+            PanelJournalRecord record;
+            if (parseMasterRow(line, p) &&
+                panelToJournalRecord(p, static_cast<uint32_t>(records.size()), record)) {
+                records.push_back(record);
+            } else {
+                rejected += "line " + std::to_string(lineNumber) + ": " + line + "\n";
+            }
         }
-        
-        if (line.empty()) {
-            continue;
+    }
+    if (!rejected.empty()) {
+        writeWholeFile(masterCsvPath + ".rejected", rejected);
+        return false;
+    }
+
+    // Written aside and renamed in, so no station ever sees half a migration
+    std::string tmpPath = journalPath + ".tmp";
+    std::error_code ec;
+    fs::remove(tmpPath, ec);
+    if (appendDurably(tmpPath, reinterpret_cast<const char*>(records.data()),
+                      records.size() * sizeof(PanelJournalRecord)) != LedgerError::None) {
+        return false;
+    }
+    fs::rename(tmpPath, journalPath, ec);
+    return !ec;
+}
+
+// Set once the journal exists and its writer is running, so the many callers
+// of ensureMasterJournalExists() stop touching the disk after the first
+static std::atomic<bool> s_journalReady{false};
+
+// Held while the journal is checked and created, so two threads that both
+// find it missing do not both migrate the CSV into it
+static std::mutex s_journalSetupMutex;
+
+bool ensureMasterJournalExists() {
+    if (s_journalReady) {
+        return true;
+    }
+    std::lock_guard<std::mutex> setupLock(s_journalSetupMutex);
+    if (s_journalReady) {
+        return true;
+    }
+    const std::string& journalPath = appPaths().masterJournal;
+    if (!fs::exists(journalPath)) {
+        ensureDirectory(appPaths().masterDir);
+
+        // Another station may have migrated while we waited for the lock
+        FileRangeLock lock(ledgerLockPath(journalPath), 0, 1);
+        if (!lock.locked()) {
+            return false;
         }
-        
-        // Extract first field (PanelID)
-        size_t commaPos = line.find(',');
-        if (commaPos == std::string::npos) {
-            continue;
+        if (!fs::exists(journalPath) && !migrateMasterCsvToJournal(journalPath)) {
+            return false;
         }
-        
-        std::string panelID = line.substr(0, commaPos);
-        
-        // Expected format: "WT-P-XXXXX"
-        if (panelID.size() >= 6 && panelID.substr(0, 5) == "WT-P-") {
-            std::string numStr = panelID.substr(5);
-            try {
-                int num = std::stoi(numStr);
-                if (num > maxNum) {
-                    maxNum = num;
-                }
-            } catch (...) {
-                // Skip invalid IDs
-            }
+    }
+
+    // Creating the writer drops any torn tail from a crash before anyone reads
+    // or numbers records, and moves older months of a migrated ledger
+    // straight into closed segments
+    masterLedgerWriter();
+    s_journalReady = true;
+    return true;
+}
+
+// Current status of every panel that has moved past Detected
+static std::mutex s_statusMutex;
+
+static PanelStatusStore& panelStatusStore() {
+    static PanelStatusStore store(appPaths().panelStatusLog);
+    return store;
+}
+
+// Catch up with status changes made since the last call, on any station
+static void refreshPanelStatuses() {
+    std::lock_guard<std::mutex> lock(s_statusMutex);
+    panelStatusStore().refresh();
+}
+
+// Replace the status written at import with the panel's current one
+static void applyCurrentStatus(Panel& panel) {
+    std::lock_guard<std::mutex> lock(s_statusMutex);
+    PanelStatusEntry entry;
+    if (panelStatusStore().find(panel.panelID, entry)) {
+        panel.status = entry.status;
+        panel.laseredAt = entry.laseredAt != 0 ? epochToTimestamp(entry.laseredAt) : std::string();
+    }
+}
+
+bool exportMasterCsv() {
+    try {
+        // Until the journal exists the CSV is the ledger; never overwrite it
+        if (!ensureMasterJournalExists()) {
+            return false;
         }
+
+        std::string masterCsvPath = appPaths().masterCsv;
+        std::string tmpPath = masterCsvPath + ".tmp";
+        std::ofstream out(tmpPath, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!out.is_open()) {
+            return false;
+        }
+
+        writeMasterCsvHeader(out);
+        refreshPanelStatuses();
+        replayLedger(appPaths().masterJournal, appPaths().segmentsDir,
+            [&out](const PanelJournalRecord& record, long long) {
+                Panel panel = journalRecordToPanel(record);
+                applyCurrentStatus(panel);
+                out << formatMasterRow(panel);
+            });
+        out.close();
+        if (out.fail()) {
+            return false;
+        }
+
+        // Swap the view in place; fails if Excel still has the old one open
+        setFileReadOnly(masterCsvPath, false);
+        std::error_code ec;
+        fs::rename(tmpPath, masterCsvPath, ec);
+
+        // Set file as read-only to prevent accidental editing
+        setFileReadOnly(masterCsvPath, true);
+        return !ec;
+    } catch (...) {
+        return false;
+    }
+}
+
+// Highest PanelID number in the ledger. The sidecar index holds the journal's
+// high-water mark, so only records appended since the last call are read;
+// closed segments answer from their footers.
+static int ledgerHighWaterId() {
+    LedgerSegmentTotals closed = ledgerSegmentTotals(appPaths().segmentsDir);
+    LedgerIndex idx = refreshLedgerIndex(appPaths().masterJournal,
+                                         appPaths().masterIndex, closed.rowCount);
+    return (std::max)(idx.highWaterId, closed.highWaterId);
+}
+
+// This station's PanelID source. Blocks come from the shared reservation
+// file and never start at or below a number already in the ledger.
+static PanelIdAllocator& stationPanelIds() {
+    static PanelIdAllocator allocator(appPaths().panelIdReservation, WolfTrackConfig::PANEL_ID_BLOCK_SIZE,
+                                      []() { return ledgerHighWaterId() + 1; });
+    return allocator;
+}
+
+std::string generateNextPanelID() {
+    if (!ensureMasterJournalExists()) {
+        return "";
     }
-    in.close();
+    int number = stationPanelIds().next();
+    return number > 0 ? formatPanelId(number) : std::string();
+}
 
-    // Increment and format
-    maxNum++;
-    std::ostringstream oss;
-    oss << "WT-P-" << std::setfill('0') << std::setw(5) << maxNum;
-    return oss.str();
+LedgerError assignPanelIds(std::vector<Panel>& panels) {
+    if (!ensureMasterJournalExists()) {
+        return LedgerError::NotMigrated;
+    }
+    for (Panel& panel : panels) {
+        panel.panelID = generateNextPanelID();
+        if (panel.panelID.empty()) {
+            return LedgerError::OpenFailed;
+        }
+    }
+    return LedgerError::None;
+}
+
+long long forEachMasterPanel(const std::function<void(const Panel&)>& visit) {
+    try {
+        if (!ensureMasterJournalExists()) {
+            return 0;
+        }
+        refreshPanelStatuses();
+        return replayLedger(appPaths().masterJournal, appPaths().segmentsDir,
+            [&visit](const PanelJournalRecord& record, long long) {
+                Panel panel = journalRecordToPanel(record);
+                applyCurrentStatus(panel);
+                visit(panel);
+            });
+    } catch (...) {
+        return 0;
+    }
+}
+
+long long forEachMasterPanelCreatedBetween(long long fromEpoch, long long toEpoch,
+                                           const std::function<void(const Panel&)>& visit) {
+    try {
+        if (!ensureMasterJournalExists()) {
+            return 0;
+        }
+        refreshPanelStatuses();
+        return replayLedgerTimeRange(appPaths().masterJournal, appPaths().segmentsDir,
+            fromEpoch, toEpoch, [&visit](const PanelJournalRecord& record, long long) {
+                Panel panel = journalRecordToPanel(record);
+                applyCurrentStatus(panel);
+                visit(panel);
+            });
+    } catch (...) {
+        return 0;
+    }
 }
 
 MasterStats computeMasterStats() {
+    MetricSpan span(MetricStage::ComputeStats);
     MasterStats stats;
     stats.totalPanels = 0;
     stats.totalPcbs = 0;
     stats.lastPanelID = "";
     
-    ensureMasterCsvExists();
-    
-    std::string masterCsvPath = getAbsolutePath(MASTER_CSV_PATH);
-    std::ifstream in(masterCsvPath);
-    if (!in.is_open()) {
+    if (!ensureMasterJournalExists()) {
         return stats;
     }
     
-    std::string line;
-    bool foundHeader = false;
-    int maxNum = 0;
+    // Totals are kept live in the ledger index and updated on every append,
+    // so this only reads records written by someone else since the last call
+    LedgerSegmentTotals closed = ledgerSegmentTotals(appPaths().segmentsDir);
+    LedgerIndex idx = refreshLedgerIndex(appPaths().masterJournal,
+                                         appPaths().masterIndex, closed.rowCount);
     
-    while (std::getline(in, line)) {
-        if (!foundHeader) {
-            foundHeader = true;
-            continue; // Skip header row
-        }
-        
-        if (line.empty()) {
-            continue;
-        }
-        
-        stats.totalPanels++;
-        
-        // Extract PanelID (first field)
-        size_t commaPos = line.find(',');
-        if (commaPos != std::string::npos) {
-            std::string panelID = line.substr(0, commaPos);
-            
-            // Track the highest numbered panel ID
-            if (panelID.size() >= 6 && panelID.substr(0, 5) == "WT-P-") {
-                std::string numStr = panelID.substr(5);
-                try {
-                    int num = std::stoi(numStr);
-                    if (num > maxNum) {
-                        maxNum = num;
-                        stats.lastPanelID = panelID;
-                    }
-                } catch (...) {
-                    // Skip invalid IDs
-                }
-            }
-        }
+    stats.totalPanels = static_cast<int>(closed.rowCount + idx.rowCount);
+    stats.totalPcbs = static_cast<int>(closed.pcbCount + idx.pcbCount);
+    int highWaterId = (std::max)(idx.highWaterId, closed.highWaterId);
+    if (highWaterId > 0) {
+        stats.lastPanelID = formatPanelId(highWaterId);
     }
-    in.close();
-    
-    stats.totalPcbs = stats.totalPanels * 24;
     
+    span.ok();
     return stats;
 }
 
-void appendPanelToMaster(const Panel& p) {
-    ensureMasterCsvExists();
-
-    std::string masterCsvPath = getAbsolutePath(MASTER_CSV_PATH);
-    
-    // Temporarily remove read-only attribute if it exists
-    DWORD attrs = GetFileAttributesA(masterCsvPath.c_str());
-    if (attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_READONLY)) {
-        SetFileAttributesA(masterCsvPath.c_str(), attrs & ~FILE_ATTRIBUTE_READONLY);
-    }
-
-    std::ofstream out(masterCsvPath, std::ios::app);
-    if (!out.is_open()) {
-        return; // in v1 we silently fail; can add error handling later
-    }
-
+std::string formatMasterRow(const Panel& p) {
     // Base fields - use Excel formula syntax ="value" to prevent leading zero removal
-    out << "=\"" << p.panelID << "\"";
+    std::string row = "=\"" + p.panelID + "\"";
 
     // 24 PCB serials - use formula syntax to preserve leading zeros
     for (size_t i = 0; i < p.pcbSerials.size(); ++i) {
-        out << ",=\"" << p.pcbSerials[i] << "\"";
+        row += ",=\"" + p.pcbSerials[i] + "\"";
     }
 
     // Operator, timestamp and status
     std::string created = p.createdAt.empty() ? currentTimestamp() : p.createdAt;
-    out << ",=\"" << g_currentOperator << "\""
-        << ",=\"" << created << "\""
-        << ",=\"" << panelStatusToString(p.status) << "\""
-        << ",=\"" << p.sourceFile << "\""
-        << "\n";
+    row += ",=\"" + (p.operatorName.empty() ? g_currentOperator : p.operatorName) + "\"";
+    row += ",=\"" + created + "\"";
+    row += ",=\"" + panelStatusToString(p.status) + "\"";
+    row += ",=\"" + p.sourceFile + "\"";
+    row += "\n";
+    return row;
+}
 
-    out.close();
-    
-    // Set file as read-only to prevent accidental editing
-    SetFileAttributesA(masterCsvPath.c_str(), FILE_ATTRIBUTE_READONLY);
+// PCB serial index over the journal, built on first use and kept current on append
+static std::mutex s_serialIndexMutex;
+static SerialIndex s_serialIndex;
+static long long s_serialIndexRows = 0;
+
+// Fold in any journal records the index has not seen yet. Caller holds the lock.
+static void catchUpSerialIndex() {
+    s_serialIndexRows += replayLedger(appPaths().masterJournal, appPaths().segmentsDir,
+        [](const PanelJournalRecord& record, long long row) {
+            s_serialIndex.addRecord(record, row);
+        }, s_serialIndexRows);
 }
 
-void moveInputPanelToArchive(const std::string& sourcePath) {
+// Add freshly committed records; if they do not follow on directly, the next
+// lookup catches up from the journal instead
+static void noteSerialsAppended(const std::vector<PanelJournalRecord>& records) {
+    std::lock_guard<std::mutex> lock(s_serialIndexMutex);
+    if (records.empty() || records.front().sequence != s_serialIndexRows) {
+        return;
+    }
+    for (const PanelJournalRecord& record : records) {
+        s_serialIndex.addRecord(record, s_serialIndexRows++);
+    }
+}
+
+std::vector<SerialDuplicate> findDuplicateSerials(const std::vector<Panel>& panels) {
+    std::vector<SerialDuplicate> duplicates;
     try {
-        std::string archiveDir = getAbsolutePath(WolfTrackConfig::INPUT_PANELS_ARCHIVE);
-        fs::create_directories(archiveDir);
+        std::lock_guard<std::mutex> lock(s_serialIndexMutex);
+        catchUpSerialIndex();
 
-        fs::path source(sourcePath);
-        if (!fs::exists(source)) {
-            return;
+        // Panels earlier in the same import count too, so a file can't repeat itself
+        SerialIndex incoming;
+        for (const Panel& panel : panels) {
+            for (const SerialDuplicate& dup : s_serialIndex.findDuplicates(panel)) {
+                duplicates.push_back(dup);
+            }
+            for (size_t i = 0; i < panel.pcbSerials.size(); ++i) {
+                SerialLocation earlier;
+                if (!panel.pcbSerials[i].empty() && incoming.findSerial(panel.pcbSerials[i], earlier)) {
+                    duplicates.push_back(SerialDuplicate{panel.pcbSerials[i], static_cast<int>(i) + 1, earlier});
+                }
+            }
+            incoming.addPanel(panel, -1);
         }
-        
+    } catch (...) {
+    }
+    return duplicates;
+}
+
+// Search index over the whole ledger; the packed store keeps a few hundred
+// bytes per panel and the index points into it
+static std::mutex s_searchMutex;
+static PackedPanelStore s_searchStore;
+static PanelSearchIndex s_searchIndex;
+static std::future<void> s_searchPreload;
+
+// Pull in ledger records the search index has not seen. Caller holds the lock.
+static void catchUpSearchIndex() {
+    long long added = replayLedger(appPaths().masterJournal, appPaths().segmentsDir,
+        [](const PanelJournalRecord& record, long long) {
+            s_searchStore.add(record);
+        }, static_cast<long long>(s_searchStore.size()));
+    if (added > 0) {
+        s_searchIndex.update(s_searchStore);
+    }
+}
+
+void preloadMasterSearchIndex() {
+    if (!ensureMasterJournalExists()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(s_searchMutex);
+    if (s_searchPreload.valid()) {
+        return;
+    }
+    s_searchPreload = std::async(std::launch::async, []() {
+        std::lock_guard<std::mutex> lock(s_searchMutex);
+        try {
+            catchUpSearchIndex();
+        } catch (...) {
+        }
+    });
+}
+
+std::vector<PanelSearchResult> searchMasterPanels(const std::string& query, PanelSearchMode mode,
+                                                  size_t maxResults) {
+    std::vector<PanelSearchResult> results;
+    try {
+        if (!ensureMasterJournalExists()) {
+            return results;
+        }
+        refreshPanelStatuses();
+        std::lock_guard<std::mutex> lock(s_searchMutex);
+        catchUpSearchIndex();
+
+        std::vector<PanelSearchHit> hits = mode == PanelSearchMode::Prefix
+            ? s_searchIndex.findPrefix(query, maxResults)
+            : s_searchIndex.findSubstring(query, maxResults);
+        for (const PanelSearchHit& hit : hits) {
+            PanelSearchResult result;
+            result.panel = s_searchStore.toPanel(hit.panel);
+            applyCurrentStatus(result.panel);
+            result.slot = hit.slot;
+            result.matched = hit.slot == 0 ? result.panel.panelID : result.panel.pcbSerials[hit.slot - 1];
+            results.push_back(result);
+        }
+    } catch (...) {
+    }
+    return results;
+}
+
+LedgerError appendPanelToMaster(const Panel& p) {
+    return appendPanelsToMaster(std::vector<Panel>{p});
+}
+
+LedgerError appendPanelsToMaster(const std::vector<Panel>& panels) {
+    MetricSpan span(MetricStage::AppendToMaster);
+    if (panels.empty()) {
+        span.ok();
+        return LedgerError::None;
+    }
+
+    if (!ensureMasterJournalExists()) {
+        return LedgerError::NotMigrated;
+    }
+
+    std::string journalPath = appPaths().masterJournal;
+    std::string indexPath = appPaths().masterIndex;
+
+    // Make sure the in-memory index is current so the new records can be folded in
+    refreshLedgerIndex(journalPath, indexPath, closedSegmentRows());
+
+    // Stamp operator and time now so the journal holds exactly what was imported
+    std::vector<Panel> stamped = panels;
+    for (Panel& p : stamped) {
+        if (p.operatorName.empty()) {
+            p.operatorName = g_currentOperator;
+        }
+        if (p.createdAt.empty()) {
+            p.createdAt = currentTimestamp();
+        }
+    }
+
+    // Blocks until the records are flushed to disk together with any
+    // appends from other threads in the same commit window
+    LedgerCommit commit = masterLedgerWriter().append(stamped);
+    if (commit.error != LedgerError::None) {
+        return commit.error;
+    }
+
+    // Keep the live stats and serial index current without re-reading the ledger
+    noteLedgerRecordsAppended(indexPath, commit.offset, commit.records);
+    noteSerialsAppended(commit.records);
+    span.ok();
+    return LedgerError::None;
+}
+
+bool moveInputPanelToArchive(const std::string& sourcePath) {
+    MetricSpan span(MetricStage::ArchiveInput);
+    try {
+        const std::string& archiveDir = appPaths().inputArchive;
+        ensureDirectory(archiveDir);
+
         // Only archive files, not directories
+        fs::path source(sourcePath);
         if (!fs::is_regular_file(source)) {
-            return;
+            return false;
         }
 
-        // Create timestamped filename for archive
-        std::string stem = source.stem().string();
-        std::string ext = source.extension().string();
-        
-        auto now = std::chrono::system_clock::now();
-        std::time_t t = std::chrono::system_clock::to_time_t(now);
-        std::tm tm{};
-#ifdef _WIN32
-        localtime_s(&tm, &t);
-#else
-        tm = *std::localtime(&t);
-#endif
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y%m%d_%H%M%S");
-        
-        std::string timestampedFilename = stem + "_" + oss.str() + ext;
-        fs::path destPath = fs::path(archiveDir) / timestampedFilename;
-
-        // Copy instead of move, so file can be run multiple times
-        fs::copy_file(source, destPath, fs::copy_options::overwrite_existing);
+        // Stored once per distinct content; the source stays so a file can be run again
+        if (!archiveFileByContent(archiveDir, sourcePath)) {
+            return false;
+        }
+        span.ok();
+        return true;
     } catch (...) {
         // Silently ignore any filesystem errors
-        return;
+        return false;
     }
 }
 
-bool loadPanelFromCsvFile(const std::string& csvPath, Panel& outPanel) {
+bool parsePanelCsvFile(const std::string& csvPath, Panel& outPanel) {
     try {
-        std::ifstream file(csvPath);
-        if (!file.is_open()) {
+        PanelCsvReader reader;
+        if (!reader.open(csvPath) || !reader.next(outPanel)) {
             return false;
         }
+        outPanel.createdAt = currentTimestamp();
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
 
-        // Read header row
-        std::string header;
-        if (!std::getline(file, header)) {
+bool parsePanelsCsvFile(const std::string& csvPath, std::vector<Panel>& outPanels) {
+    try {
+        PanelCsvReader reader;
+        if (!reader.open(csvPath)) {
             return false;
         }
 
-        // Read data row
-        std::string dataLine;
-        if (!std::getline(file, dataLine)) {
+        std::string createdAt = currentTimestamp();
+        std::vector<Panel> panels;
+        Panel panel;
+        while (reader.next(panel)) {
+            panel.createdAt = createdAt;
+            panels.push_back(panel);
+        }
+
+        // Reject the whole file if any row is malformed so it can be fixed and re-run
+        if (reader.failed() || panels.empty()) {
             return false;
         }
+        outPanels.insert(outPanels.end(), panels.begin(), panels.end());
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
 
-        // Split the data row by comma
-        std::vector<std::string> fields;
-        std::stringstream ss(dataLine);
-        std::string field;
-        while (std::getline(ss, field, ',')) {
-            // Trim trailing whitespace
-            while (!field.empty() && (field.back() == '\r' || field.back() == ' ')) {
-                field.pop_back();
-            }
-            while (!field.empty() && field.front() == ' ') {
-                field.erase(field.begin());
+bool loadPanelFromCsvFile(const std::string& csvPath, Panel& outPanel, PanelLoadReport& report,
+                          const std::function<void(LoadStep)>& progress) {
+    MetricSpan span(MetricStage::LoadPanelCsv);
+    report = PanelLoadReport();
+    // An MES export may hold a whole shift of panels; all rows go to the ledger
+    std::vector<Panel> panels;
+    if (!parsePanelsCsvFile(csvPath, panels)) {
+        return false;
+    }
+    if (progress) {
+        progress(LoadStep::Parsed);
+    }
+
+    // A serial that was already lasered means a mixed-up or re-sent panel
+    report.duplicates = findDuplicateSerials(panels);
+    if (!report.duplicates.empty() && WolfTrackConfig::REJECT_DUPLICATE_SERIALS) {
+        return false;
+    }
+
+    // Reserved PanelIDs, unique across every station sharing the ledger
+    report.ledgerError = assignPanelIds(panels);
+    if (report.ledgerError != LedgerError::None) {
+        return false;
+    }
+
+    // Save to the master ledger
+    report.ledgerError = appendPanelsToMaster(panels);
+    if (report.ledgerError != LedgerError::None) {
+        return false;
+    }
+    if (progress) {
+        progress(LoadStep::Saved);
+    }
+
+    // Move input file to archive
+    if (moveInputPanelToArchive(csvPath) && progress) {
+        progress(LoadStep::Archived);
+    }
+
+    // The first panel in the file is the one shown on screen
+    outPanel = panels.front();
+    span.ok();
+    return true;
+}
+
+StatusChangeError setPanelStatus(const std::string& panelID, PanelStatus status) {
+    try {
+        if (!ensureMasterJournalExists()) {
+            return StatusChangeError::WriteFailed;
+        }
+        {
+            // The serial index also maps every PanelID in the ledger to its row
+            std::lock_guard<std::mutex> lock(s_serialIndexMutex);
+            catchUpSerialIndex();
+            long long row = 0;
+            if (!s_serialIndex.findPanelRow(panelID, row)) {
+                return StatusChangeError::UnknownPanel;
             }
-            fields.push_back(field);
         }
 
-        if (fields.size() < 25) {
-            return false;
+        StatusChangeError error;
+        {
+            std::lock_guard<std::mutex> lock(s_statusMutex);
+            error = panelStatusStore().change(panelID, status, g_currentOperator,
+                                              timestampToEpoch(currentTimestamp()));
         }
-
-        // Fill the Panel object - Use Panel ID from CSV file
-        outPanel.panelID = fields[0];
-        outPanel.panelNumber = fields[0]; // Keep same for compatibility
-        for (size_t i = 0; i < 24; ++i) {
-            outPanel.pcbSerials[i] = fields[i + 1];
+        // Lasered artwork is done with; also retries earlier moves that failed
+        if (error == StatusChangeError::None && status == PanelStatus::Lasered) {
+            moveLaseredArtToCompleted();
         }
-        outPanel.status = PanelStatus::Detected;
-        outPanel.createdAt = currentTimestamp();
-        outPanel.laseredAt = "";
-        outPanel.sourceFile = csvPath;
+        return error;
+    } catch (...) {
+        return StatusChangeError::WriteFailed;
+    }
+}
 
-        // Close the file before moving it
-        file.close();
+PanelStatus currentPanelStatus(const std::string& panelID) {
+    std::lock_guard<std::mutex> lock(s_statusMutex);
+    panelStatusStore().refresh();
+    return panelStatusStore().statusOf(panelID);
+}
 
-        // Save to master CSV
-        appendPanelToMaster(outPanel);
+std::vector<std::string> panelsWithStatus(PanelStatus status) {
+    std::lock_guard<std::mutex> lock(s_statusMutex);
+    panelStatusStore().refresh();
+    const std::set<std::string>& ids = panelStatusStore().panelsIn(status);
+    return std::vector<std::string>(ids.begin(), ids.end());
+}
 
-        // Move input file to archive
-        moveInputPanelToArchive(csvPath);
+std::vector<Panel> findMasterPanels(const std::vector<std::string>& panelIDs) {
+    std::vector<Panel> panels;
+    try {
+        if (!ensureMasterJournalExists()) {
+            return panels;
+        }
+        std::vector<long long> rows;
+        {
+            std::lock_guard<std::mutex> lock(s_serialIndexMutex);
+            catchUpSerialIndex();
+            for (const std::string& panelID : panelIDs) {
+                long long row = 0;
+                if (s_serialIndex.findPanelRow(panelID, row)) {
+                    rows.push_back(row);
+                }
+            }
+        }
 
-        return true;
+        // The packed search store holds the ledger in record order, so a row is its index there
+        refreshPanelStatuses();
+        std::lock_guard<std::mutex> lock(s_searchMutex);
+        catchUpSearchIndex();
+        for (long long row : rows) {
+            if (row >= 0 && static_cast<size_t>(row) < s_searchStore.size()) {
+                Panel panel = s_searchStore.toPanel(static_cast<size_t>(row));
+                applyCurrentStatus(panel);
+                panels.push_back(panel);
+            }
+        }
     } catch (...) {
-        return false;
     }
+    return panels;
+}
+
+std::string getPendingArtRoot() {
+    return appPaths().pendingArt;
 }
 
 std::string getPanelPendingFolder(const Panel& panel) {
-    std::string pendingRoot = getAbsolutePath(WolfTrackConfig::PENDING_ART_ROOT);
-    fs::path folder = fs::path(pendingRoot) / panel.panelID;
+    std::string folder = (fs::path(appPaths().pendingArt) / panel.panelID).string();
     
-    fs::create_directories(folder);
+    // Remembered per process, so only the first file for a panel costs a mkdir
+    ensureDirectory(appPaths().pendingArt);
+    ensureDirectory(folder);
     
-    return folder.string();
+    return folder;
+}
+
+// Panels with artwork in PendingArt, kept in the pending-work manifest
+static std::mutex s_pendingMutex;
+
+// The queue, caught up with the manifest. Caller holds s_pendingMutex.
+// On the first run without a manifest it is seeded once from the folders
+// already in PendingArt.
+static PendingArtQueue& pendingArtQueue() {
+    static PendingArtQueue queue(appPaths().pendingArtManifest);
+    queue.refresh();
+    if (!queue.hasManifest()) {
+        std::vector<std::string> existing;
+        std::error_code ec;
+        for (const auto& item : fs::directory_iterator(appPaths().pendingArt, ec)) {
+            std::string name = item.path().filename().string();
+            // Folders too long to be a PanelID are not panels' artwork
+            if (item.is_directory(ec) && name.size() < sizeof(PendingArtRecord::panelID)) {
+                existing.push_back(name);
+            }
+        }
+        queue.add(existing, timestampToEpoch(currentTimestamp()));
+    }
+    return queue;
+}
+
+void notePanelArtPending(const std::vector<std::string>& panelIDs) {
+    try {
+        std::lock_guard<std::mutex> lock(s_pendingMutex);
+        pendingArtQueue().add(panelIDs, timestampToEpoch(currentTimestamp()));
+    } catch (...) {
+    }
+}
+
+std::vector<std::string> pendingArtPanels() {
+    std::lock_guard<std::mutex> lock(s_pendingMutex);
+    const std::set<std::string>& panels = pendingArtQueue().panels();
+    return std::vector<std::string>(panels.begin(), panels.end());
+}
+
+size_t pendingArtCount() {
+    std::lock_guard<std::mutex> lock(s_pendingMutex);
+    return pendingArtQueue().size();
+}
+
+bool movePanelArtToCompleted(const std::string& panelID) {
+    try {
+        if (panelID.empty()) {
+            return false;
+        }
+        fs::path from = fs::path(appPaths().pendingArt) / panelID;
+        fs::path to = fs::path(appPaths().completedArt) / panelID;
+        ensureDirectory(appPaths().completedArt);
+
+        // Keep an earlier completed folder of the same name rather than merge into it
+        std::error_code ec;
+        for (int n = 2; fs::exists(to, ec); ++n) {
+            to = fs::path(appPaths().completedArt) / (panelID + "_" + std::to_string(n));
+        }
+
+        // One rename within the same volume; Windows refuses while the folder is open
+        fs::rename(from, to, ec);
+        if (ec && fs::exists(from)) {
+            return false;
+        }
+        forgetDirectory(from.string());
+
+        // The folder's record and the index say where it is now
+        PanelMetadataRecord metadata;
+        if (findPanelMetadata(panelID, metadata) || readPanelMetadataFiles(to.string(), ArtLocation::Completed, metadata)) {
+            setPanelMetadataLocation(metadata, ArtLocation::Completed);
+            writePanelMetadataFiles(to.string(), metadata);
+            recordPanelMetadata({metadata});
+        }
+
+        std::lock_guard<std::mutex> lock(s_pendingMutex);
+        return pendingArtQueue().remove({panelID}, timestampToEpoch(currentTimestamp()));
+    } catch (...) {
+        return false;
+    }
+}
+
+int moveLaseredArtToCompleted() {
+    std::vector<std::string> lasered;
+    {
+        std::lock_guard<std::mutex> pendingLock(s_pendingMutex);
+        std::lock_guard<std::mutex> statusLock(s_statusMutex);
+        panelStatusStore().refresh();
+        for (const std::string& panelID : pendingArtQueue().panels()) {
+            if (panelStatusStore().statusOf(panelID) == PanelStatus::Lasered) {
+                lasered.push_back(panelID);
+            }
+        }
+    }
+
+    int moved = 0;
+    for (const std::string& panelID : lasered) {
+        if (movePanelArtToCompleted(panelID)) {
+            moved++;
+        }
+    }
+    return moved;
+}
+
+// Latest metadata of every panel folder, kept in the aggregated index
+static std::mutex s_metadataMutex;
+
+// Collect the metadata of every folder under an art root, for seeding the index
+static void readArtRootMetadata(const std::string& root, ArtLocation location,
+                                std::vector<PanelMetadataRecord>& out) {
+    std::error_code ec;
+    for (const auto& item : fs::directory_iterator(root, ec)) {
+        PanelMetadataRecord record;
+        if (item.is_directory(ec) && readPanelMetadataFiles(item.path().string(), location, record)) {
+            out.push_back(record);
+        }
+    }
+}
+
+// The index, caught up with the file. Caller holds s_metadataMutex. On the
+// first run without an index it is built once from the folders' own files.
+static PanelMetadataIndex& panelMetadataIndex() {
+    static PanelMetadataIndex index(appPaths().panelMetadataIndex);
+    index.refresh();
+    if (!index.hasIndex()) {
+        std::vector<PanelMetadataRecord> existing;
+        readArtRootMetadata(appPaths().pendingArt, ArtLocation::Pending, existing);
+        readArtRootMetadata(appPaths().completedArt, ArtLocation::Completed, existing);
+        index.put(existing);
+    }
+    return index;
+}
+
+void recordPanelMetadata(const std::vector<PanelMetadataRecord>& records) {
+    try {
+        std::lock_guard<std::mutex> lock(s_metadataMutex);
+        panelMetadataIndex().put(records);
+    } catch (...) {
+    }
+}
+
+bool findPanelMetadata(const std::string& panelID, PanelMetadataRecord& out) {
+    std::lock_guard<std::mutex> lock(s_metadataMutex);
+    return panelMetadataIndex().find(panelID, out);
+}
+
+std::vector<PanelMetadataRecord> allPanelMetadata() {
+    std::lock_guard<std::mutex> lock(s_metadataMutex);
+    std::vector<PanelMetadataRecord> records;
+    for (const auto& entry : panelMetadataIndex().records()) {
+        records.push_back(entry.second);
+    }
+    return records;
+}
+
+// Write an SVG into a panel's PendingArt folder. The folder is only created
+// once per process, so if it was moved away since (e.g. to CompletedArt),
+// recreate it and try again.
+static bool writeSvgToPanelFolder(const SvgWriter& svg, const std::string& folder, const fs::path& svgPath) {
+    if (svg.writeToFile(svgPath.string())) {
+        return true;
+    }
+    forgetDirectory(folder);
+    return ensureDirectory(folder) && svg.writeToFile(svgPath.string());
+}
+
+// Per-thread writer so repeated artwork generation reuses one buffer
+static SvgWriter& artworkSvgWriter() {
+    static thread_local SvgWriter writer;
+    return writer;
+}
+
+void buildPanelArtSvg(const Panel& panel, const std::string& operatorName, SvgWriter& svg) {
+    svg.clear();
+    svg.raw("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    svg.raw("<svg width=\"").number(PANEL_ART_WIDTH).raw("\" height=\"").number(PANEL_ART_HEIGHT)
+       .raw("\" xmlns=\"http://www.w3.org/2000/svg\">\n");
+    svg.raw("  <!-- AVO Invents Ltd - WolfTrack Panel Artwork -->\n");
+    writePanelArtBody(panel, operatorName, svg);
+    svg.raw("</svg>\n");
+}
+
+void writePanelArtBody(const Panel& panel, const std::string& operatorName, SvgWriter& svg) {
+    const int svgWidth = PANEL_ART_WIDTH;
+    const int svgHeight = PANEL_ART_HEIGHT;
+
+    // Grid layout matching GUI
+    const int originX = 20;
+    const int originY = 100;
+    const int cols = 6;
+    const int rows = 4;
+    const int slotWidth = 120;
+    const int slotHeight = 60;
+    const int hGap = 10;
+    const int vGap = 10;
+
+    // White background
+    svg.raw("  <rect width=\"").number(svgWidth).raw("\" height=\"").number(svgHeight)
+       .raw("\" fill=\"white\"/>\n");
+
+    // Header information
+    svg.raw("  <text x=\"20\" y=\"30\" font-family=\"Arial\" font-size=\"18\" "
+            "font-weight=\"bold\" fill=\"black\">Panel ID: ").text(panel.panelID).raw("</text>\n");
+    svg.raw("  <text x=\"20\" y=\"55\" font-family=\"Arial\" font-size=\"16\" "
+            "fill=\"black\">Operator: ").text(operatorName).raw("</text>\n");
+    svg.raw("  <text x=\"20\" y=\"75\" font-family=\"Arial\" font-size=\"14\" "
+            "fill=\"gray\">Created: ").text(panel.createdAt).raw("</text>\n");
+
+    // Draw 24 PCB slots in 6x4 grid
+    for (int i = 0; i < 24; ++i) {
+        int x = originX + (i % cols) * (slotWidth + hGap);
+        int y = originY + (i / cols) * (slotHeight + vGap);
+
+        // Draw rectangle for PCB slot
+        svg.rect(x, y, slotWidth, slotHeight, "fill=\"none\" stroke=\"black\" stroke-width=\"1.5\"");
+
+        // Draw PCB number
+        svg.raw("  <text x=\"").number(x + 5).raw("\" y=\"").number(y + 18)
+           .raw("\" font-family=\"Arial\" font-size=\"12\" font-weight=\"bold\" "
+                "fill=\"black\">PCB").number(i + 1).raw("</text>\n");
+
+        // Draw serial number (first 12 chars for space)
+        std::string_view serial = std::string_view(panel.pcbSerials[i]).substr(0, 12);
+        svg.raw("  <text x=\"").number(x + 5).raw("\" y=\"").number(y + 38)
+           .raw("\" font-family=\"Courier New\" font-size=\"10\" "
+                "fill=\"black\">").text(serial).raw("</text>\n");
+    }
+
+    // Outer panel border
+    int panelWidth = cols * (slotWidth + hGap) - hGap;
+    int panelHeight = rows * (slotHeight + vGap) - vGap;
+    svg.rect(originX - 5, originY - 5, panelWidth + 10, panelHeight + 10,
+             "fill=\"none\" stroke=\"blue\" stroke-width=\"2\"");
+}
+
+std::string formatPanelInfo(const Panel& panel, const std::string& operatorName, const MasterStats& stats) {
+    return formatPanelInfoText(panel.panelID, operatorName, panel.createdAt, stats.totalPanels, stats.totalPcbs,
+                               panel.sourceFile);
 }
 
 std::string createPanelArtSvg(const Panel& panel) {
+    MetricSpan span(MetricStage::PanelArtSvg);
     try {
+        // Lasered artwork has already moved to CompletedArt; leave it there
+        if (currentPanelStatus(panel.panelID) == PanelStatus::Lasered) {
+            return "";
+        }
         std::string folder = getPanelPendingFolder(panel);
         fs::path svgPath = fs::path(folder) / (panel.panelID + "_panel_art.svg");
-        
-        std::ofstream svg(svgPath);
-        if (!svg.is_open()) {
+
+        SvgWriter& svg = artworkSvgWriter();
+        buildPanelArtSvg(panel, g_currentOperator, svg);
+        if (!writeSvgToPanelFolder(svg, folder, svgPath)) {
             return "";
         }
         
-        // SVG dimensions for full panel artwork
-        int svgWidth = 800;
-        int svgHeight = 550;
-        
-        // Grid layout matching GUI
-        int originX = 20;
-        int originY = 100;
-        int cols = 6;
-        int rows = 4;
-        int slotWidth = 120;
-        int slotHeight = 60;
-        int hGap = 10;
-        int vGap = 10;
-        
-        svg << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-        svg << "<svg width=\"" << svgWidth << "\" height=\"" << svgHeight 
-            << "\" xmlns=\"http://www.w3.org/2000/svg\">\n";
-        svg << "  <!-- AVO Invents Ltd - WolfTrack Panel Artwork -->\n";
-        
-        // White background
-        svg << "  <rect width=\"" << svgWidth << "\" height=\"" << svgHeight 
-            << "\" fill=\"white\"/>\n";
-        
-        // Header information
-        svg << "  <text x=\"20\" y=\"30\" font-family=\"Arial\" font-size=\"18\" "
-            << "font-weight=\"bold\" fill=\"black\">Panel ID: " << panel.panelID << "</text>\n";
-        svg << "  <text x=\"20\" y=\"55\" font-family=\"Arial\" font-size=\"16\" "
-            << "fill=\"black\">Operator: " << g_currentOperator << "</text>\n";
-        svg << "  <text x=\"20\" y=\"75\" font-family=\"Arial\" font-size=\"14\" "
-            << "fill=\"gray\">Created: " << panel.createdAt << "</text>\n";
-        
-        // Draw 24 PCB slots in 6x4 grid
-        for (int i = 0; i < 24; ++i) {
-            int row = i / cols;
-            int col = i % cols;
-            
-            int x = originX + col * (slotWidth + hGap);
-            int y = originY + row * (slotHeight + vGap);
-            
-            // Draw rectangle for PCB slot
-            svg << "  <rect x=\"" << x << "\" y=\"" << y 
-                << "\" width=\"" << slotWidth << "\" height=\"" << slotHeight
-                << "\" fill=\"none\" stroke=\"black\" stroke-width=\"1.5\"/>\n";
-            
-            // PCB label and serial (truncated to first 12 chars for space)
-            std::string pcbLabel = "PCB" + std::to_string(i + 1);
-            std::string serial = panel.pcbSerials[i];
-            if (serial.length() > 12) {
-                serial = serial.substr(0, 12);
-            }
-            
-            // Draw PCB number
-            svg << "  <text x=\"" << (x + 5) << "\" y=\"" << (y + 18)
-                << "\" font-family=\"Arial\" font-size=\"12\" font-weight=\"bold\" "
-                << "fill=\"black\">" << pcbLabel << "</text>\n";
-            
-            // Draw serial number
-            svg << "  <text x=\"" << (x + 5) << "\" y=\"" << (y + 38)
-                << "\" font-family=\"Courier New\" font-size=\"10\" "
-                << "fill=\"black\">" << serial << "</text>\n";
-        }
-        
-        // Outer panel border
-        int panelWidth = cols * (slotWidth + hGap) - hGap;
-        int panelHeight = rows * (slotHeight + vGap) - vGap;
-        svg << "  <rect x=\"" << (originX - 5) << "\" y=\"" << (originY - 5)
-            << "\" width=\"" << (panelWidth + 10) << "\" height=\"" << (panelHeight + 10)
-            << "\" fill=\"none\" stroke=\"blue\" stroke-width=\"2\"/>\n";
-        
-        svg << "</svg>\n";
-        svg.close();
-        
-        // STAGE 1 UPGRADE: Create panel_info.txt metadata file
-        fs::path infoPath = fs::path(folder) / "panel_info.txt";
-        std::ofstream infoFile(infoPath);
-        if (infoFile.is_open()) {
-            MasterStats stats = computeMasterStats();
-            infoFile << "PanelID: " << panel.panelID << "\n";
-            infoFile << "Operator: " << g_currentOperator << "\n";
-            infoFile << "CreatedAt: " << panel.createdAt << "\n";
-            infoFile << "TotalPanelsAtCreation: " << stats.totalPanels << "\n";
-            infoFile << "TotalPCBsAtCreation: " << stats.totalPcbs << "\n";
-            infoFile << "SourceCSV: " << panel.sourceFile << "\n";
-            infoFile.close();
+        // STAGE 1 UPGRADE: Create panel_info metadata (binary record + text view)
+        MasterStats stats = computeMasterStats();
+        PanelMetadataRecord metadata;
+        if (makePanelMetadata(panel, g_currentOperator, stats.totalPanels, stats.totalPcbs,
+                              timestampToEpoch(currentTimestamp()), metadata)) {
+            writePanelMetadataFiles(folder, metadata);
+            recordPanelMetadata({metadata});
+        } else {
+            // Too long for the record; the text file still gets every field in full
+            writeWholeFile((fs::path(folder) / "panel_info.txt").string(),
+                           formatPanelInfo(panel, g_currentOperator, stats));
         }
+        notePanelArtPending({panel.panelID});
         
+        span.ok();
         return svgPath.string();
     } catch (...) {
         return "";
     }
 }
 
-std::string createPanelBarcodeSvgPlaceholder(const Panel& panel) {
+std::string dataMatrixPayload(const Panel& panel) {
+    std::string payload = panel.panelID;
+    if (WolfTrackConfig::DATAMATRIX_INCLUDE_SERIALS) {
+        // Empty slots stay as empty fields so positions survive a scan
+        for (const std::string& serial : panel.pcbSerials) {
+            payload += ';';
+            payload += serial;
+        }
+    }
+    return payload;
+}
+
+bool buildPanelDataMatrixSvg(const Panel& panel, const std::string& operatorName, SvgWriter& svg) {
+    DataMatrixSymbol symbol;
+    if (!encodeDataMatrix(dataMatrixPayload(panel), symbol)) {
+        return false;
+    }
+    buildDataMatrixLabelSvg(panel, symbol, operatorName, svg);
+    return true;
+}
+
+// Label layout for a symbol: the code fits a 120 unit square with a one-module
+// quiet zone; large symbols (serials included) keep a 2 unit minimum and widen the label
+struct DataMatrixLabelLayout {
+    int moduleSize;
+    int codeSpan;
+    int width;
+    int height;
+    int startX;
+    int startY;
+    int textY;
+};
+
+static DataMatrixLabelLayout dataMatrixLabelLayout(const DataMatrixSymbol& symbol) {
+    DataMatrixLabelLayout layout;
+    layout.moduleSize = (std::max)(2, 120 / (symbol.size + 2));  // Parenthesised to dodge the windows.h max macro
+    layout.codeSpan = (symbol.size + 2) * layout.moduleSize;
+    layout.width = (std::max)(220, layout.codeSpan + 80);
+    layout.startX = (layout.width - layout.codeSpan) / 2;
+    layout.startY = 30;
+    layout.textY = layout.startY + layout.codeSpan + 40;
+    layout.height = layout.textY + 45;
+    return layout;
+}
+
+void dataMatrixLabelSize(const DataMatrixSymbol& symbol, int& width, int& height) {
+    DataMatrixLabelLayout layout = dataMatrixLabelLayout(symbol);
+    width = layout.width;
+    height = layout.height;
+}
+
+void buildDataMatrixLabelSvg(const Panel& panel, const DataMatrixSymbol& symbol,
+                             const std::string& operatorName, SvgWriter& svg) {
+    DataMatrixLabelLayout layout = dataMatrixLabelLayout(symbol);
+    svg.clear();
+    svg.raw("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    svg.raw("<svg width=\"").number(layout.width).raw("\" height=\"").number(layout.height)
+       .raw("\" xmlns=\"http://www.w3.org/2000/svg\">\n");
+    svg.raw("  <!-- ECC200 DataMatrix Label -->\n");
+    writeDataMatrixLabelBody(panel, symbol, operatorName, svg);
+    svg.raw("</svg>\n");
+}
+
+void writeDataMatrixLabelBody(const Panel& panel, const DataMatrixSymbol& symbol,
+                              const std::string& operatorName, SvgWriter& svg) {
+    DataMatrixLabelLayout layout = dataMatrixLabelLayout(symbol);
+    int textY = layout.textY;
+
+    svg.raw("  <rect width=\"").number(layout.width).raw("\" height=\"").number(layout.height)
+       .raw("\" fill=\"white\"/>\n");
+
+    // One path of merged horizontal runs instead of a rect per module
+    writeDataMatrixSvgPath(symbol, layout.startX + layout.moduleSize, layout.startY + layout.moduleSize,
+                           layout.moduleSize, svg);
+
+    // Add panel ID text below the code
+    int centerX = layout.width / 2;
+    svg.raw("  <text x=\"").number(centerX).raw("\" y=\"").number(textY)
+       .raw("\" font-family=\"Arial\" font-size=\"16\" font-weight=\"bold\" text-anchor=\"middle\" fill=\"black\">")
+       .text(panel.panelID).raw("</text>\n");
+
+    // Add operator text
+    svg.raw("  <text x=\"").number(centerX).raw("\" y=\"").number(textY + 25)
+       .raw("\" font-family=\"Arial\" font-size=\"14\" text-anchor=\"middle\" fill=\"black\">Operator: ")
+       .text(operatorName).raw("</text>\n");
+}
+
+std::string createPanelDataMatrixSvg(const Panel& panel) {
+    MetricSpan span(MetricStage::DataMatrixSvg);
     try {
         std::string folder = getPanelPendingFolder(panel);
         fs::path svgPath = fs::path(folder) / (panel.panelID + "_datamatrix.svg");
-        
-        std::ofstream svg(svgPath);
-        if (!svg.is_open()) {
+
+        SvgWriter& svg = artworkSvgWriter();
+        if (!buildPanelDataMatrixSvg(panel, g_currentOperator, svg)) {
             return "";
         }
-        
-        // Write SVG for DataMatrix-style label
-        svg << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-        svg << "<svg width=\"220\" height=\"260\" xmlns=\"http://www.w3.org/2000/svg\">\n";
-        svg << "  <!-- Placeholder DataMatrix Label -->\n";
-        svg << "  <rect width=\"220\" height=\"260\" fill=\"white\"/>\n";
-        
-        // Draw a 10x10 grid pattern to simulate DataMatrix code
-        int gridSize = 10;
-        int cellSize = 12;
-        int startX = 40;
-        int startY = 30;
-        
-        for (int row = 0; row < gridSize; ++row) {
-            for (int col = 0; col < gridSize; ++col) {
-                // Simple pattern for placeholder
-                if ((row + col) % 2 == 0 || row == 0 || col == 0 || row == gridSize-1 || col == gridSize-1) {
-                    int x = startX + col * cellSize;
-                    int y = startY + row * cellSize;
-                    svg << "  <rect x=\"" << x << "\" y=\"" << y 
-                        << "\" width=\"" << cellSize << "\" height=\"" << cellSize 
-                        << "\" fill=\"black\"/>\n";
-                }
-            }
+        if (!writeSvgToPanelFolder(svg, folder, svgPath)) {
+            return "";
         }
-        
-        // Add border around the code
-        svg << "  <rect x=\"" << (startX - 5) << "\" y=\"" << (startY - 5) 
-            << "\" width=\"" << (gridSize * cellSize + 10) << "\" height=\"" << (gridSize * cellSize + 10)
-            << "\" fill=\"none\" stroke=\"black\" stroke-width=\"2\"/>\n";
-        
-        // Add panel ID text below the barcode
-        svg << "  <text x=\"110\" y=\"190\" font-family=\"Arial\" font-size=\"16\" "
-            << "font-weight=\"bold\" text-anchor=\"middle\" fill=\"black\">" 
-            << panel.panelID << "</text>\n";
-        
-        // Add operator text
-        svg << "  <text x=\"110\" y=\"215\" font-family=\"Arial\" font-size=\"14\" "
-            << "text-anchor=\"middle\" fill=\"black\">Operator: " 
-            << g_currentOperator << "</text>\n";
-        
-        svg << "</svg>\n";
-        svg.close();
-        
+
+        span.ok();
         return svgPath.string();
     } catch (...) {
         return "";
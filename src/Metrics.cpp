@@ -0,0 +1,194 @@
+#include "Metrics.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+// Timings are bucketed by microseconds: values below 4 get a bucket each,
+// above that every power of two is split into four buckets
+static const int SUB_BUCKETS = 4;
+static const int BUCKET_COUNT = SUB_BUCKETS * 63;
+
+struct StageHistogram {
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<long long> errors{0};
+    std::atomic<long long> totalMicros{0};
+    std::atomic<long long> maxMicros{0};
+};
+
+static StageHistogram s_histograms[METRIC_STAGE_COUNT];
+
+static int bucketOf(uint64_t micros) {
+    if (micros < SUB_BUCKETS) {
+        return static_cast<int>(micros);
+    }
+    int msb = 2;
+    while ((micros >> (msb + 1)) != 0) {
+        msb++;
+    }
+    int sub = static_cast<int>((micros >> (msb - 2)) & (SUB_BUCKETS - 1));
+    return SUB_BUCKETS * (msb - 1) + sub;
+}
+
+// Middle of the range of values that land in a bucket
+static uint64_t bucketMidpoint(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int msb = bucket / SUB_BUCKETS + 1;
+    uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << (msb - 2);
+    return lower + ((uint64_t(1) << (msb - 2)) >> 1);
+}
+
+const char* metricStageName(MetricStage stage) {
+    switch (stage) {
+        case MetricStage::LoadPanelCsv:   return "load_panel_csv";
+        case MetricStage::AppendToMaster: return "append_to_master";
+        case MetricStage::ArchiveInput:   return "archive_input";
+        case MetricStage::ComputeStats:   return "compute_stats";
+        case MetricStage::PanelArtSvg:    return "panel_art_svg";
+        case MetricStage::DataMatrixSvg:  return "datamatrix_svg";
+    }
+    return "unknown";
+}
+
+void recordMetric(MetricStage stage, long long micros, bool failed) {
+    StageHistogram& h = s_histograms[static_cast<int>(stage)];
+    micros = (std::max)(micros, 0LL);
+    h.buckets[bucketOf(static_cast<uint64_t>(micros))].fetch_add(1, std::memory_order_relaxed);
+    h.totalMicros.fetch_add(micros, std::memory_order_relaxed);
+    if (failed) {
+        h.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    long long seen = h.maxMicros.load(std::memory_order_relaxed);
+    while (micros > seen && !h.maxMicros.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+}
+
+// Middle of the bucket holding the q-th fraction of the samples, capped at
+// the largest value actually seen
+static double percentileMs(const uint64_t* buckets, long long count, long long maxMicros, double q) {
+    if (count == 0) {
+        return 0.0;
+    }
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return static_cast<double>((std::min)(bucketMidpoint(i), static_cast<uint64_t>(maxMicros))) / 1000.0;
+        }
+    }
+    return static_cast<double>(maxMicros) / 1000.0;
+}
+
+std::vector<MetricSummary> metricsSnapshot() {
+    std::vector<MetricSummary> summaries;
+    for (int s = 0; s < METRIC_STAGE_COUNT; ++s) {
+        const StageHistogram& h = s_histograms[s];
+        // Counters are read one by one while other threads record; a dump may
+        // be off by the few samples landing meanwhile, which is fine here
+        uint64_t buckets[BUCKET_COUNT];
+        long long count = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            buckets[i] = h.buckets[i].load(std::memory_order_relaxed);
+            count += static_cast<long long>(buckets[i]);
+        }
+        long long maxMicros = h.maxMicros.load(std::memory_order_relaxed);
+
+        MetricSummary summary;
+        summary.stage = metricStageName(static_cast<MetricStage>(s));
+        summary.count = count;
+        summary.errors = h.errors.load(std::memory_order_relaxed);
+        summary.p50Ms = percentileMs(buckets, count, maxMicros, 0.50);
+        summary.p99Ms = percentileMs(buckets, count, maxMicros, 0.99);
+        summary.maxMs = static_cast<double>(maxMicros) / 1000.0;
+        summary.totalMs = static_cast<double>(h.totalMicros.load(std::memory_order_relaxed)) / 1000.0;
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+std::string formatMetrics(const std::vector<MetricSummary>& summaries) {
+    std::ostringstream out;
+    out << "# WolfTrack stage latencies since start, written " << currentTimestamp() << "\n";
+    out << std::left << std::setw(18) << "stage" << std::right
+        << std::setw(10) << "count" << std::setw(8) << "errors"
+        << std::setw(12) << "p50_ms" << std::setw(12) << "p99_ms"
+        << std::setw(12) << "max_ms" << std::setw(14) << "total_ms" << "\n";
+    out << std::fixed << std::setprecision(3);
+    for (const MetricSummary& m : summaries) {
+        out << std::left << std::setw(18) << m.stage << std::right
+            << std::setw(10) << m.count << std::setw(8) << m.errors
+            << std::setw(12) << m.p50Ms << std::setw(12) << m.p99Ms
+            << std::setw(12) << m.maxMs << std::setw(14) << m.totalMs << "\n";
+    }
+    return out.str();
+}
+
+bool writeMetricsFile(const std::string& path) {
+    try {
+        // Written beside the target and renamed over it so a reader never sees half a file
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::out | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+            out << formatMetrics(metricsSnapshot());
+            if (!out) {
+                return false;
+            }
+        }
+        std::error_code ec;
+        fs::rename(tmpPath, path, ec);
+        return !ec;
+    } catch (...) {
+        return false;
+    }
+}
+
+static std::mutex s_dumpMutex;
+static std::condition_variable s_dumpWake;
+static std::thread s_dumpThread;
+static std::string s_dumpPath;
+static bool s_dumpStopping = false;
+
+void startMetricsDump(const std::string& path, std::chrono::seconds interval) {
+    stopMetricsDump();
+    std::lock_guard<std::mutex> lock(s_dumpMutex);
+    s_dumpPath = path;
+    s_dumpStopping = false;
+    s_dumpThread = std::thread([path, interval]() {
+        std::unique_lock<std::mutex> lock(s_dumpMutex);
+        while (!s_dumpWake.wait_for(lock, interval, []() { return s_dumpStopping; })) {
+            lock.unlock();
+            writeMetricsFile(path);
+            lock.lock();
+        }
+    });
+}
+
+void stopMetricsDump() {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(s_dumpMutex);
+        if (!s_dumpThread.joinable()) {
+            return;
+        }
+        s_dumpStopping = true;
+        path = s_dumpPath;
+    }
+    s_dumpWake.notify_all();
+    s_dumpThread.join();
+    writeMetricsFile(path);
+}
@@ -0,0 +1,117 @@
+#include "PackedPanel.h"
+#include "LedgerSegments.h"
+#include "Timestamp.h"
+#include <cstring>
+
+uint32_t StringInterner::intern(std::string_view text) {
+    auto it = m_ids.find(text);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(m_strings.size());
+    m_strings.emplace_back(text);
+    m_ids.emplace(std::string_view(m_strings.back()), id);
+    return id;
+}
+
+void PackedPanelStore::appendField(PackedPanel& packed, int field, const char* text, size_t length) {
+    packed.fieldLengths[field] = static_cast<uint8_t>(length);
+    m_arena.insert(m_arena.end(), text, text + length);
+}
+
+bool PackedPanelStore::add(const Panel& panel) {
+    // Lengths are stored in one byte each; ledger fields are far shorter
+    if (panel.panelID.size() > 255 || panel.panelNumber.size() > 255) {
+        return false;
+    }
+    for (const std::string& serial : panel.pcbSerials) {
+        if (serial.size() > 255) {
+            return false;
+        }
+    }
+
+    PackedPanel packed;
+    packed.createdAt = timestampToEpoch(panel.createdAt);
+    packed.laseredAt = timestampToEpoch(panel.laseredAt);
+    packed.arenaOffset = m_arena.size();
+    packed.operatorId = m_names.intern(panel.operatorName);
+    packed.sourceFileId = m_names.intern(panel.sourceFile);
+    packed.status = static_cast<uint8_t>(panel.status);
+
+    appendField(packed, 0, panel.panelID.data(), panel.panelID.size());
+    appendField(packed, 1, panel.panelNumber.data(), panel.panelNumber.size());
+    for (int i = 0; i < 24; ++i) {
+        appendField(packed, 2 + i, panel.pcbSerials[i].data(), panel.pcbSerials[i].size());
+    }
+    m_panels.push_back(packed);
+    return true;
+}
+
+void PackedPanelStore::add(const PanelJournalRecord& record) {
+    PackedPanel packed;
+    packed.createdAt = record.createdAt;
+    packed.laseredAt = record.laseredAt;
+    packed.arenaOffset = m_arena.size();
+    packed.operatorId = m_names.intern(std::string_view(record.operatorName,
+        strnlen(record.operatorName, sizeof(record.operatorName))));
+    packed.sourceFileId = m_names.intern(std::string_view(record.sourceFile,
+        strnlen(record.sourceFile, sizeof(record.sourceFile))));
+    packed.status = record.status;
+
+    // Journal fields are at most 31 bytes, so the lengths always fit
+    appendField(packed, 0, record.panelID, strnlen(record.panelID, sizeof(record.panelID)));
+    appendField(packed, 1, record.panelNumber, strnlen(record.panelNumber, sizeof(record.panelNumber)));
+    for (int i = 0; i < 24; ++i) {
+        appendField(packed, 2 + i, record.pcbSerials[i], strnlen(record.pcbSerials[i], sizeof(record.pcbSerials[i])));
+    }
+    m_panels.push_back(packed);
+}
+
+std::string_view PackedPanelStore::field(size_t index, int field) const {
+    const PackedPanel& packed = m_panels[index];
+    size_t offset = packed.arenaOffset;
+    for (int i = 0; i < field; ++i) {
+        offset += packed.fieldLengths[i];
+    }
+    return std::string_view(m_arena.data() + offset, packed.fieldLengths[field]);
+}
+
+Panel PackedPanelStore::toPanel(size_t index) const {
+    const PackedPanel& packed = m_panels[index];
+    Panel panel;
+    const char* text = m_arena.data() + packed.arenaOffset;
+    panel.panelID.assign(text, packed.fieldLengths[0]);
+    text += packed.fieldLengths[0];
+    panel.panelNumber.assign(text, packed.fieldLengths[1]);
+    text += packed.fieldLengths[1];
+    for (int i = 0; i < 24; ++i) {
+        panel.pcbSerials[i].assign(text, packed.fieldLengths[2 + i]);
+        text += packed.fieldLengths[2 + i];
+    }
+    panel.createdAt = epochToTimestamp(packed.createdAt);
+    panel.laseredAt = epochToTimestamp(packed.laseredAt);
+    panel.status = static_cast<PanelStatus>(packed.status);
+    panel.operatorName = m_names.lookup(packed.operatorId);
+    panel.sourceFile = m_names.lookup(packed.sourceFileId);
+    return panel;
+}
+
+void PackedPanelStore::reserve(size_t panels, size_t arenaBytes) {
+    m_panels.reserve(panels);
+    m_arena.reserve(arenaBytes);
+}
+
+size_t PackedPanelStore::memoryUsed() const {
+    size_t bytes = m_panels.capacity() * sizeof(PackedPanel) + m_arena.capacity();
+    for (size_t i = 0; i < m_names.size(); ++i) {
+        bytes += m_names.lookup(static_cast<uint32_t>(i)).capacity();
+    }
+    return bytes;
+}
+
+long long loadPackedPanels(const std::string& journalPath, const std::string& segmentsDir,
+                           PackedPanelStore& store) {
+    return replayLedger(journalPath, segmentsDir, [&store](const PanelJournalRecord& record, long long) {
+        store.add(record);
+    });
+}
@@ -9,3 +9,10 @@ std::string panelStatusToString(PanelStatus status) {
         default:                         return "Unknown";
     }
 }
+
+PanelStatus panelStatusFromString(const std::string& text) {
+    if (text == "LabelPrinted")  return PanelStatus::LabelPrinted;
+    if (text == "ReadyForLaser") return PanelStatus::ReadyForLaser;
+    if (text == "Lasered")       return PanelStatus::Lasered;
+    return PanelStatus::Detected;
+}
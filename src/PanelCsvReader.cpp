@@ -0,0 +1,94 @@
+#include "PanelCsvReader.h"
+#include <array>
+#include <fstream>
+
+// Trim spaces and carriage returns from both ends of a field
+static std::string_view trimField(std::string_view field) {
+    size_t start = 0;
+    while (start < field.size() && field[start] == ' ') {
+        start++;
+    }
+    size_t end = field.size();
+    while (end > start && (field[end - 1] == '\r' || field[end - 1] == ' ')) {
+        end--;
+    }
+    return field.substr(start, end - start);
+}
+
+// Return the next line (without its newline) and advance pos past it
+static std::string_view nextLine(const std::string& buffer, size_t& pos) {
+    size_t end = buffer.find('\n', pos);
+    if (end == std::string::npos) {
+        end = buffer.size();
+    }
+    std::string_view line(buffer.data() + pos, end - pos);
+    pos = (end < buffer.size()) ? end + 1 : end;
+    return line;
+}
+
+bool PanelCsvReader::open(const std::string& csvPath) {
+    m_path = csvPath;
+    m_buffer.clear();
+    m_pos = 0;
+    m_failed = false;
+
+    std::ifstream file(csvPath, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // One block read for the whole file
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    if (size <= 0) {
+        return false;
+    }
+    m_buffer.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    if (!file.read(&m_buffer[0], size)) {
+        return false;
+    }
+
+    // Skip header row
+    nextLine(m_buffer, m_pos);
+    return m_pos < m_buffer.size();
+}
+
+bool PanelCsvReader::next(Panel& outPanel) {
+    while (m_pos < m_buffer.size()) {
+        std::string_view line = nextLine(m_buffer, m_pos);
+        if (trimField(line).empty()) {
+            continue;
+        }
+
+        // Split into the 25 fields we use; extra trailing fields are ignored
+        std::array<std::string_view, 25> fields;
+        size_t count = 0;
+        size_t start = 0;
+        while (count < fields.size()) {
+            size_t comma = line.find(',', start);
+            fields[count++] = trimField(line.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start));
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            start = comma + 1;
+        }
+
+        if (count < fields.size()) {
+            m_failed = true;
+            return false;
+        }
+
+        // Fill the Panel object - Use Panel ID from CSV file
+        outPanel.panelID.assign(fields[0]);
+        outPanel.panelNumber.assign(fields[0]); // Keep same for compatibility
+        for (size_t i = 0; i < 24; ++i) {
+            outPanel.pcbSerials[i].assign(fields[i + 1]);
+        }
+        outPanel.status = PanelStatus::Detected;
+        outPanel.laseredAt.clear();
+        outPanel.sourceFile = m_path;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,77 @@
+#include "PanelIdReservation.h"
+#include "PanelJournal.h"
+#include "Platform.h"
+#include <algorithm>
+#include <cstddef>
+
+static uint32_t reservationCrc(const PanelIdReservationRecord& record) {
+    return journalCrc32(&record, offsetof(PanelIdReservationRecord, crc));
+}
+
+PanelIdRange reservePanelIdRange(const std::string& reservationPath, int count, int floor) {
+    PanelIdRange range = {0, 0};
+    if (count <= 0) {
+        return range;
+    }
+
+    // Held only for one 16-byte read-modify-write, so stations rarely wait
+    FileRangeLock lock(reservationPath, 0, sizeof(PanelIdReservationRecord));
+    if (!lock.locked()) {
+        return range;
+    }
+
+    PanelIdReservationRecord record = {};
+    int next = (std::max)(floor, 1);
+    if (lock.read(0, &record, sizeof(record)) && record.magic == PANEL_ID_RESERVATION_MAGIC &&
+        record.crc == reservationCrc(record)) {
+        next = (std::max)(next, static_cast<int>(record.nextId));
+    }
+
+    record = {};
+    record.magic = PANEL_ID_RESERVATION_MAGIC;
+    record.nextId = next + count;
+    record.crc = reservationCrc(record);
+    if (lock.write(0, &record, sizeof(record)) != FileWriteError::None) {
+        return range;
+    }
+
+    range.first = next;
+    range.count = count;
+    return range;
+}
+
+static uint64_t packBlock(int next, int end) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(next)) << 32) | static_cast<uint32_t>(end);
+}
+
+PanelIdAllocator::PanelIdAllocator(const std::string& reservationPath, int blockSize, std::function<int()> floor)
+    : m_path(reservationPath), m_blockSize((std::max)(blockSize, 1)), m_floor(std::move(floor)) {
+}
+
+int PanelIdAllocator::next() {
+    uint64_t block = m_block.load();
+    while (true) {
+        int next = static_cast<int>(block >> 32);
+        int end = static_cast<int>(block & 0xFFFFFFFFu);
+        if (next < end) {
+            if (m_block.compare_exchange_weak(block, packBlock(next + 1, end))) {
+                return next;
+            }
+            continue; // block now holds the current value
+        }
+
+        // Block used up: one thread refills it, the rest retry against the new one
+        std::lock_guard<std::mutex> lock(m_refillMutex);
+        uint64_t current = m_block.load();
+        if (current != block) {
+            block = current;
+            continue;
+        }
+        PanelIdRange range = reservePanelIdRange(m_path, m_blockSize, m_floor ? m_floor() : 1);
+        if (range.count == 0) {
+            return 0;
+        }
+        m_block.store(packBlock(range.first + 1, range.first + range.count));
+        return range.first;
+    }
+}
@@ -0,0 +1,222 @@
+#include "PanelJournal.h"
+#include "Timestamp.h"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+// Records read per block when replaying
+static const size_t REPLAY_BLOCK_RECORDS = 256;
+
+uint32_t journalCrc32(const void* bytes, size_t length) {
+    const unsigned char* data = static_cast<const unsigned char*>(bytes);
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static uint32_t recordCrc(const PanelJournalRecord& record) {
+    return journalCrc32(&record, offsetof(PanelJournalRecord, crc));
+}
+
+// Copy text into a fixed field, leaving room for the terminating NUL
+static bool copyField(char* dest, size_t destSize, const std::string& text) {
+    if (text.size() >= destSize) {
+        return false;
+    }
+    std::memcpy(dest, text.data(), text.size());
+    return true;
+}
+
+// Read a NUL-padded fixed field back into a string
+static std::string readField(const char* src, size_t srcSize) {
+    return std::string(src, strnlen(src, srcSize));
+}
+
+bool panelToJournalRecord(const Panel& panel, uint32_t sequence, PanelJournalRecord& out) {
+    std::memset(&out, 0, sizeof(out));
+    out.magic = JOURNAL_RECORD_MAGIC;
+    out.sequence = sequence;
+    out.createdAt = panel.createdAt.empty() ? timestampToEpoch(currentTimestamp())
+                                            : timestampToEpoch(panel.createdAt);
+    out.laseredAt = timestampToEpoch(panel.laseredAt);
+    out.status = static_cast<uint8_t>(panel.status);
+
+    // Identity fields must fit exactly; anything else would corrupt the ledger
+    if (!copyField(out.panelID, sizeof(out.panelID), panel.panelID)
+        || !copyField(out.panelNumber, sizeof(out.panelNumber), panel.panelNumber)) {
+        return false;
+    }
+    for (size_t i = 0; i < panel.pcbSerials.size(); ++i) {
+        if (!copyField(out.pcbSerials[i], sizeof(out.pcbSerials[i]), panel.pcbSerials[i])) {
+            return false;
+        }
+    }
+
+    // Descriptive fields are truncated instead; for paths keep the file name end
+    std::string op = panel.operatorName.substr(0, sizeof(out.operatorName) - 1);
+    copyField(out.operatorName, sizeof(out.operatorName), op);
+    std::string source = panel.sourceFile;
+    if (source.size() >= sizeof(out.sourceFile)) {
+        source = source.substr(source.size() - (sizeof(out.sourceFile) - 1));
+    }
+    copyField(out.sourceFile, sizeof(out.sourceFile), source);
+
+    out.crc = recordCrc(out);
+    return true;
+}
+
+Panel journalRecordToPanel(const PanelJournalRecord& record) {
+    Panel panel;
+    panel.panelID = readField(record.panelID, sizeof(record.panelID));
+    panel.panelNumber = readField(record.panelNumber, sizeof(record.panelNumber));
+    for (size_t i = 0; i < panel.pcbSerials.size(); ++i) {
+        panel.pcbSerials[i] = readField(record.pcbSerials[i], sizeof(record.pcbSerials[i]));
+    }
+    panel.createdAt = epochToTimestamp(record.createdAt);
+    panel.laseredAt = epochToTimestamp(record.laseredAt);
+    panel.status = static_cast<PanelStatus>(record.status);
+    panel.sourceFile = readField(record.sourceFile, sizeof(record.sourceFile));
+    panel.operatorName = readField(record.operatorName, sizeof(record.operatorName));
+    return panel;
+}
+
+bool isValidJournalRecord(const PanelJournalRecord& record) {
+    return record.magic == JOURNAL_RECORD_MAGIC && record.crc == recordCrc(record);
+}
+
+void setJournalRecordSequence(PanelJournalRecord& record, uint32_t sequence) {
+    record.sequence = sequence;
+    record.crc = recordCrc(record);
+}
+
+long long recoverJournalTail(const std::string& journalPath) {
+    std::error_code ec;
+    if (!fs::exists(journalPath, ec)) {
+        return 0;
+    }
+    unsigned long long size = fs::file_size(journalPath, ec);
+    if (ec) {
+        return -1;
+    }
+
+    // Torn writes only ever damage the end, so walk backwards from the last
+    // whole record until one checks out
+    unsigned long long good = size - (size % sizeof(PanelJournalRecord));
+    {
+        std::ifstream in(journalPath, std::ios::in | std::ios::binary);
+        if (!in.is_open()) {
+            return -1;
+        }
+        PanelJournalRecord record;
+        while (good > 0) {
+            in.seekg(static_cast<std::streamoff>(good - sizeof(record)));
+            if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+                return -1;
+            }
+            if (isValidJournalRecord(record)) {
+                break;
+            }
+            good -= sizeof(record);
+        }
+    }
+
+    if (good != size) {
+        fs::resize_file(journalPath, good, ec);
+        if (ec) {
+            return -1;
+        }
+    }
+    return static_cast<long long>(size - good);
+}
+
+bool appendPanelsToJournal(const std::string& journalPath, const std::vector<Panel>& panels,
+                           JournalAppendResult* result) {
+    if (panels.empty()) {
+        return true;
+    }
+
+    std::error_code ec;
+    unsigned long long size = fs::exists(journalPath, ec) ? fs::file_size(journalPath, ec) : 0;
+    if (ec) {
+        return false;
+    }
+
+    // A partial record at the end is from an interrupted write; drop it so
+    // new records stay aligned
+    unsigned long long aligned = size - (size % sizeof(PanelJournalRecord));
+    if (aligned != size) {
+        fs::resize_file(journalPath, aligned, ec);
+        if (ec) {
+            return false;
+        }
+    }
+
+    uint32_t sequence = static_cast<uint32_t>(aligned / sizeof(PanelJournalRecord));
+    std::vector<PanelJournalRecord> records(panels.size());
+    for (size_t i = 0; i < panels.size(); ++i) {
+        if (!panelToJournalRecord(panels[i], sequence + static_cast<uint32_t>(i), records[i])) {
+            return false;
+        }
+    }
+
+    std::ofstream out(journalPath, std::ios::app | std::ios::binary);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(PanelJournalRecord)));
+    out.close();
+    if (out.fail()) {
+        return false;
+    }
+
+    if (result != nullptr) {
+        result->offset = static_cast<long long>(aligned);
+        result->records = std::move(records);
+    }
+    return true;
+}
+
+long long replayPanelJournal(const std::string& journalPath,
+                             const std::function<void(const PanelJournalRecord&, long long)>& visit,
+                             long long firstRecord) {
+    std::ifstream in(journalPath, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        return 0;
+    }
+    in.seekg(static_cast<std::streamoff>(firstRecord * static_cast<long long>(sizeof(PanelJournalRecord))));
+
+    std::vector<PanelJournalRecord> block(REPLAY_BLOCK_RECORDS);
+    long long count = 0;
+    while (in) {
+        in.read(reinterpret_cast<char*>(block.data()),
+                static_cast<std::streamsize>(block.size() * sizeof(PanelJournalRecord)));
+        size_t whole = static_cast<size_t>(in.gcount()) / sizeof(PanelJournalRecord);
+        for (size_t i = 0; i < whole; ++i) {
+            if (!isValidJournalRecord(block[i])) {
+                return count;
+            }
+            visit(block[i], firstRecord + count);
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,217 @@
+#include "PanelMetadata.h"
+#include "PanelJournal.h"
+#include "Platform.h"
+#include "SvgWriter.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// Rewrite the index once it holds this many more records than panels
+static const long long COMPACT_SLACK_RECORDS = 1024;
+
+static uint32_t metadataCrc(const PanelMetadataRecord& record) {
+    return journalCrc32(&record, offsetof(PanelMetadataRecord, crc));
+}
+
+static bool readIndexHeader(const PanelMetadataRecord& record, long long& generation) {
+    if (record.magic != PANEL_METADATA_HEADER_MAGIC || record.crc != metadataCrc(record)) {
+        return false;
+    }
+    generation = record.generatedAt;
+    return true;
+}
+
+static PanelMetadataRecord makeIndexHeader(long long generation) {
+    PanelMetadataRecord header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = PANEL_METADATA_HEADER_MAGIC;
+    header.version = 1;
+    header.generatedAt = generation;
+    header.crc = metadataCrc(header);
+    return header;
+}
+
+// Copy text into a fixed field, leaving room for the terminating NUL
+static bool copyField(char* dest, size_t destSize, const std::string& text) {
+    if (text.size() >= destSize) {
+        return false;
+    }
+    std::memcpy(dest, text.data(), text.size());
+    return true;
+}
+
+static std::string readField(const char* src, size_t srcSize) {
+    return std::string(src, strnlen(src, srcSize));
+}
+
+std::string formatPanelInfoText(const std::string& panelID, const std::string& operatorName,
+                                const std::string& createdAt, int totalPanels, int totalPcbs,
+                                const std::string& sourceFile) {
+    std::ostringstream info;
+    info << "PanelID: " << panelID << "\n";
+    info << "Operator: " << operatorName << "\n";
+    info << "CreatedAt: " << createdAt << "\n";
+    info << "TotalPanelsAtCreation: " << totalPanels << "\n";
+    info << "TotalPCBsAtCreation: " << totalPcbs << "\n";
+    info << "SourceCSV: " << sourceFile << "\n";
+    return info.str();
+}
+
+bool makePanelMetadata(const Panel& panel, const std::string& operatorName, int totalPanels,
+                       int totalPcbs, long long generatedAt, PanelMetadataRecord& out) {
+    std::memset(&out, 0, sizeof(out));
+    if (panel.panelID.empty()
+        || !copyField(out.panelID, sizeof(out.panelID), panel.panelID)
+        || !copyField(out.createdAtText, sizeof(out.createdAtText), panel.createdAt)
+        || !copyField(out.operatorName, sizeof(out.operatorName), operatorName)
+        || !copyField(out.sourceFile, sizeof(out.sourceFile), panel.sourceFile)) {
+        return false;
+    }
+    out.magic = PANEL_METADATA_MAGIC;
+    out.version = 1;
+    out.createdAt = timestampToEpoch(panel.createdAt);
+    out.generatedAt = generatedAt;
+    out.totalPanelsAtCreation = totalPanels;
+    out.totalPcbsAtCreation = totalPcbs;
+    out.location = static_cast<uint8_t>(ArtLocation::Pending);
+    out.crc = metadataCrc(out);
+    return true;
+}
+bool isValidPanelMetadata(const PanelMetadataRecord& record) {
+    return record.magic == PANEL_METADATA_MAGIC && record.crc == metadataCrc(record);
+}
+
+void setPanelMetadataLocation(PanelMetadataRecord& record, ArtLocation location) {
+    record.location = static_cast<uint8_t>(location);
+    record.crc = metadataCrc(record);
+}
+
+std::string panelMetadataID(const PanelMetadataRecord& record) {
+    return readField(record.panelID, sizeof(record.panelID));
+}
+
+std::string formatPanelMetadataText(const PanelMetadataRecord& record) {
+    return formatPanelInfoText(panelMetadataID(record), readField(record.operatorName, sizeof(record.operatorName)),
+                               readField(record.createdAtText, sizeof(record.createdAtText)),
+                               record.totalPanelsAtCreation, record.totalPcbsAtCreation,
+                               readField(record.sourceFile, sizeof(record.sourceFile)));
+}
+
+bool parsePanelInfoText(const std::string& text, ArtLocation location, PanelMetadataRecord& out) {
+    Panel panel;
+    std::string operatorName;
+    int totalPanels = 0;
+    int totalPcbs = 0;
+
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t colon = line.find(": ");
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, colon);
+        std::string value = line.substr(colon + 2);
+        if (key == "PanelID") panel.panelID = value;
+        else if (key == "Operator") operatorName = value;
+        else if (key == "CreatedAt") panel.createdAt = value;
+        else if (key == "TotalPanelsAtCreation") totalPanels = std::atoi(value.c_str());
+        else if (key == "TotalPCBsAtCreation") totalPcbs = std::atoi(value.c_str());
+        else if (key == "SourceCSV") panel.sourceFile = value;
+    }
+    if (!makePanelMetadata(panel, operatorName, totalPanels, totalPcbs, 0, out)) {
+        return false;
+    }
+    setPanelMetadataLocation(out, location);
+    return true;
+}
+
+bool writePanelMetadataFiles(const std::string& folder, const PanelMetadataRecord& record) {
+    bool binaryOk = writeWholeFile((fs::path(folder) / PANEL_METADATA_FILE).string(),
+                                   std::string_view(reinterpret_cast<const char*>(&record), sizeof(record)));
+    bool textOk = writeWholeFile((fs::path(folder) / "panel_info.txt").string(), formatPanelMetadataText(record));
+    return binaryOk && textOk;
+}
+
+bool readPanelMetadataFiles(const std::string& folder, ArtLocation location, PanelMetadataRecord& out) {
+    std::ifstream binary(fs::path(folder) / PANEL_METADATA_FILE, std::ios::in | std::ios::binary);
+    if (binary.read(reinterpret_cast<char*>(&out), sizeof(out)) && isValidPanelMetadata(out)) {
+        setPanelMetadataLocation(out, location);
+        return true;
+    }
+
+    // Folders from before the binary record only have the text file
+    std::ifstream text(fs::path(folder) / "panel_info.txt", std::ios::in | std::ios::binary);
+    if (!text.is_open()) {
+        return false;
+    }
+    std::stringstream contents;
+    contents << text.rdbuf();
+    return parsePanelInfoText(contents.str(), location, out);
+}
+
+static const RecordLogFormat<PanelMetadataRecord> METADATA_INDEX_FORMAT = {isValidPanelMetadata, readIndexHeader,
+                                                                            makeIndexHeader};
+
+PanelMetadataIndex::PanelMetadataIndex(const std::string& indexPath)
+    : m_log(indexPath, METADATA_INDEX_FORMAT,
+            [this](const PanelMetadataRecord& record) { m_latest[panelMetadataID(record)] = record; },
+            [this]() { m_latest.clear(); }) {
+}
+
+void PanelMetadataIndex::refresh() {
+    m_log.refresh();
+}
+
+bool PanelMetadataIndex::find(const std::string& panelID, PanelMetadataRecord& out) const {
+    auto it = m_latest.find(panelID);
+    if (it == m_latest.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
+}
+
+bool PanelMetadataIndex::put(const std::vector<PanelMetadataRecord>& records) {
+    FileRangeLock lock(m_log.lockPath(), 0, 1);
+    if (!lock.locked()) {
+        return false;
+    }
+    m_log.refresh();
+
+    std::vector<PanelMetadataRecord> valid;
+    for (const PanelMetadataRecord& record : records) {
+        if (isValidPanelMetadata(record)) {
+            valid.push_back(record);
+        }
+    }
+    // Even with nothing to record the first put creates the index, so a
+    // station seeding from empty art folders does not seed again
+    if (!m_log.append(valid)) {
+        return false;
+    }
+
+    if (m_log.records() > 2 * static_cast<long long>(m_latest.size()) + COMPACT_SLACK_RECORDS) {
+        compact();
+    }
+    return true;
+}
+
+// Rewrite the index with the latest record per panel. Caller holds the lock.
+void PanelMetadataIndex::compact() {
+    std::vector<PanelMetadataRecord> live;
+    live.reserve(m_latest.size());
+    for (const auto& entry : m_latest) {
+        live.push_back(entry.second);
+    }
+    m_log.compact(live);
+}
@@ -0,0 +1,216 @@
+#include "PanelSearch.h"
+#include <algorithm>
+#include <unordered_map>
+
+// Unsorted keys tolerated before the next update rebuilds: at least this many,
+// or an eighth of the sorted keys on large ledgers
+static const size_t MIN_RECENT_KEYS = 4096;
+
+// Serials and PanelIDs are ASCII; searches ignore case
+static unsigned char fold(char c) {
+    return (c >= 'a' && c <= 'z') ? static_cast<unsigned char>(c - 'a' + 'A') : static_cast<unsigned char>(c);
+}
+
+static int compareFolded(std::string_view a, std::string_view b) {
+    size_t n = (std::min)(a.size(), b.size());
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char x = fold(a[i]);
+        unsigned char y = fold(b[i]);
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+    return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+}
+
+static bool startsWithFolded(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && compareFolded(text.substr(0, prefix.size()), prefix) == 0;
+}
+
+static bool containsFolded(std::string_view text, std::string_view needle) {
+    if (needle.size() > text.size()) {
+        return false;
+    }
+    for (size_t i = 0; i + needle.size() <= text.size(); ++i) {
+        if (startsWithFolded(text.substr(i), needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t trigramAt(std::string_view text, size_t i) {
+    return (uint32_t(fold(text[i])) << 16) | (uint32_t(fold(text[i + 1])) << 8) | uint32_t(fold(text[i + 2]));
+}
+
+std::string_view PanelSearchIndex::keyText(const PanelSearchHit& key) const {
+    return key.slot == 0 ? m_store->panelID(key.panel) : m_store->serial(key.panel, key.slot);
+}
+
+void PanelSearchIndex::addPanelKeys(uint32_t panel, std::vector<PanelSearchHit>& keys) const {
+    if (!m_store->panelID(panel).empty()) {
+        keys.push_back(PanelSearchHit{panel, 0});
+    }
+    for (int slot = 1; slot <= 24; ++slot) {
+        if (!m_store->serial(panel, slot).empty()) {
+            keys.push_back(PanelSearchHit{panel, static_cast<uint8_t>(slot)});
+        }
+    }
+}
+
+void PanelSearchIndex::build(const PackedPanelStore& store) {
+    m_store = &store;
+    std::vector<PanelSearchHit> keys;
+    for (size_t i = 0; i < store.size(); ++i) {
+        addPanelKeys(static_cast<uint32_t>(i), keys);
+    }
+    m_indexedPanels = store.size();
+    m_recent.clear();
+
+    // Resolve each key's text once; looking it up inside the sort costs more than the sort
+    std::vector<std::string_view> texts(keys.size());
+    std::vector<uint32_t> order(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        texts[i] = keyText(keys[i]);
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&texts](uint32_t a, uint32_t b) {
+        return compareFolded(texts[a], texts[b]) < 0;
+    });
+    m_sorted.resize(keys.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        m_sorted[i] = keys[order[i]];
+    }
+
+    // Two passes over the keys in sorted order: count the keys under each
+    // trigram, then fill one list per trigram. Lists come out ascending with no sort.
+    struct TrigramList {
+        uint32_t count = 0;
+        uint32_t next = 0;      // Where the next posting goes in the second pass
+        uint32_t lastKey = 0;   // Last key counted + 1, so a key is listed once per trigram
+    };
+    std::unordered_map<uint32_t, TrigramList> lists;
+    auto forEachTrigram = [&](auto&& visit) {
+        for (size_t i = 0; i < m_sorted.size(); ++i) {
+            std::string_view text = texts[order[i]];
+            for (size_t j = 0; j + 3 <= text.size(); ++j) {
+                TrigramList& list = lists[trigramAt(text, j)];
+                if (list.lastKey != i + 1) {
+                    list.lastKey = static_cast<uint32_t>(i + 1);
+                    visit(list, static_cast<uint32_t>(i));
+                }
+            }
+        }
+    };
+    forEachTrigram([](TrigramList& list, uint32_t) { list.count++; });
+
+    m_trigrams.clear();
+    for (const auto& entry : lists) {
+        m_trigrams.push_back(entry.first);
+    }
+    std::sort(m_trigrams.begin(), m_trigrams.end());
+    m_postingStarts.assign(1, 0);
+    for (uint32_t trigram : m_trigrams) {
+        TrigramList& list = lists[trigram];
+        list.next = m_postingStarts.back();
+        list.lastKey = 0;
+        m_postingStarts.push_back(list.next + list.count);
+    }
+
+    m_postings.assign(m_postingStarts.back(), 0);
+    forEachTrigram([this](TrigramList& list, uint32_t key) { m_postings[list.next++] = key; });
+}
+
+void PanelSearchIndex::update(const PackedPanelStore& store) {
+    if (m_store != &store) {
+        build(store);
+        return;
+    }
+    for (size_t i = m_indexedPanels; i < store.size(); ++i) {
+        addPanelKeys(static_cast<uint32_t>(i), m_recent);
+    }
+    m_indexedPanels = store.size();
+    if (m_recent.size() > (std::max)(MIN_RECENT_KEYS, m_sorted.size() / 8)) {
+        build(store);
+    }
+}
+
+std::vector<PanelSearchHit> PanelSearchIndex::findPrefix(std::string_view prefix, size_t maxHits) const {
+    std::vector<PanelSearchHit> hits;
+    if (m_store == nullptr) {
+        return hits;
+    }
+    auto it = std::lower_bound(m_sorted.begin(), m_sorted.end(), prefix,
+        [this](const PanelSearchHit& key, std::string_view value) {
+            return compareFolded(keyText(key), value) < 0;
+        });
+    for (; it != m_sorted.end() && hits.size() < maxHits && startsWithFolded(keyText(*it), prefix); ++it) {
+        hits.push_back(*it);
+    }
+    for (const PanelSearchHit& key : m_recent) {
+        if (hits.size() >= maxHits) {
+            break;
+        }
+        if (startsWithFolded(keyText(key), prefix)) {
+            hits.push_back(key);
+        }
+    }
+    return hits;
+}
+
+std::vector<PanelSearchHit> PanelSearchIndex::findSubstring(std::string_view text, size_t maxHits) const {
+    std::vector<PanelSearchHit> hits;
+    if (m_store == nullptr) {
+        return hits;
+    }
+
+    if (text.size() < 3) {
+        // Too short for a trigram; a scan over ~31-byte keys is still quick
+        for (const PanelSearchHit& key : m_sorted) {
+            if (hits.size() >= maxHits) {
+                return hits;
+            }
+            if (containsFolded(keyText(key), text)) {
+                hits.push_back(key);
+            }
+        }
+    } else {
+        // Start from the rarest trigram in the query and check each candidate
+        size_t best = m_postings.size() + 1;
+        size_t bestBegin = 0;
+        for (size_t j = 0; j + 3 <= text.size(); ++j) {
+            auto found = std::lower_bound(m_trigrams.begin(), m_trigrams.end(), trigramAt(text, j));
+            if (found == m_trigrams.end() || *found != trigramAt(text, j)) {
+                best = 0;  // A trigram no key has: nothing in the sorted keys can match
+                break;
+            }
+            size_t t = static_cast<size_t>(found - m_trigrams.begin());
+            size_t length = m_postingStarts[t + 1] - m_postingStarts[t];
+            if (length < best) {
+                best = length;
+                bestBegin = m_postingStarts[t];
+            }
+        }
+        for (size_t i = 0; i < best && best <= m_postings.size() && hits.size() < maxHits; ++i) {
+            const PanelSearchHit& key = m_sorted[m_postings[bestBegin + i]];
+            if (containsFolded(keyText(key), text)) {
+                hits.push_back(key);
+            }
+        }
+    }
+
+    for (const PanelSearchHit& key : m_recent) {
+        if (hits.size() >= maxHits) {
+            break;
+        }
+        if (containsFolded(keyText(key), text)) {
+            hits.push_back(key);
+        }
+    }
+    return hits;
+}
+
+size_t PanelSearchIndex::memoryUsed() const {
+    return m_sorted.capacity() * sizeof(PanelSearchHit) + m_recent.capacity() * sizeof(PanelSearchHit) +
+           (m_trigrams.capacity() + m_postingStarts.capacity() + m_postings.capacity()) * sizeof(uint32_t);
+}
@@ -0,0 +1,108 @@
+#include "PanelStatusLog.h"
+#include "PanelJournal.h"
+#include "Platform.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+static uint32_t statusRecordCrc(const PanelStatusRecord& record) {
+    return journalCrc32(&record, offsetof(PanelStatusRecord, crc));
+}
+
+static bool isValidStatusRecord(const PanelStatusRecord& record) {
+    return record.magic == STATUS_RECORD_MAGIC && record.toStatus <= static_cast<uint8_t>(PanelStatus::Lasered)
+        && record.crc == statusRecordCrc(record);
+}
+
+std::string statusChangeErrorToString(StatusChangeError error) {
+    switch (error) {
+        case StatusChangeError::None:              return "OK";
+        case StatusChangeError::UnknownPanel:      return "No panel with that PanelID is in the master ledger";
+        case StatusChangeError::InvalidTransition: return "A panel's status can only move forward";
+        case StatusChangeError::WriteFailed:       return "The panel status log could not be written";
+        default:                                   return "Unknown status error";
+    }
+}
+
+bool isAllowedStatusTransition(PanelStatus from, PanelStatus to) {
+    return static_cast<int>(to) > static_cast<int>(from);
+}
+
+// The status log has no header; it is never compacted
+static const RecordLogFormat<PanelStatusRecord> STATUS_LOG_FORMAT = {isValidStatusRecord, nullptr, nullptr};
+
+PanelStatusStore::PanelStatusStore(const std::string& logPath)
+    : m_log(logPath, STATUS_LOG_FORMAT, [this](const PanelStatusRecord& record) { apply(record); }) {
+}
+
+void PanelStatusStore::apply(const PanelStatusRecord& record) {
+    std::string panelID(record.panelID, strnlen(record.panelID, sizeof(record.panelID)));
+    PanelStatus to = static_cast<PanelStatus>(record.toStatus);
+
+    auto inserted = m_current.emplace(panelID, PanelStatusEntry{PanelStatus::Detected, 0, 0, std::string()});
+    PanelStatusEntry& entry = inserted.first->second;
+    if (!inserted.second) {
+        m_byStatus[static_cast<size_t>(entry.status)].erase(panelID);
+    }
+    entry.status = to;
+    entry.changedAt = record.changedAt;
+    entry.operatorName.assign(record.operatorName, strnlen(record.operatorName, sizeof(record.operatorName)));
+    if (to == PanelStatus::Lasered) {
+        entry.laseredAt = record.changedAt;
+    }
+    m_byStatus[static_cast<size_t>(to)].insert(panelID);
+}
+
+void PanelStatusStore::refresh() {
+    m_log.refresh();
+}
+
+PanelStatus PanelStatusStore::statusOf(const std::string& panelID) const {
+    auto it = m_current.find(panelID);
+    return it == m_current.end() ? PanelStatus::Detected : it->second.status;
+}
+
+bool PanelStatusStore::find(const std::string& panelID, PanelStatusEntry& out) const {
+    auto it = m_current.find(panelID);
+    if (it == m_current.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
+}
+
+const std::set<std::string>& PanelStatusStore::panelsIn(PanelStatus status) const {
+    return m_byStatus[static_cast<size_t>(status)];
+}
+
+StatusChangeError PanelStatusStore::change(const std::string& panelID, PanelStatus to,
+                                           const std::string& operatorName, long long atEpoch) {
+    PanelStatusRecord record;
+    std::memset(&record, 0, sizeof(record));
+    if (panelID.empty() || panelID.size() >= sizeof(record.panelID)) {
+        return StatusChangeError::UnknownPanel;
+    }
+
+    // Another station may change the same panel; check and append as one step
+    FileRangeLock lock(m_log.lockPath(), 0, 1);
+    if (!lock.locked()) {
+        return StatusChangeError::WriteFailed;
+    }
+    m_log.refresh();
+
+    PanelStatus from = statusOf(panelID);
+    if (!isAllowedStatusTransition(from, to)) {
+        return StatusChangeError::InvalidTransition;
+    }
+
+    record.magic = STATUS_RECORD_MAGIC;
+    record.fromStatus = static_cast<uint8_t>(from);
+    record.toStatus = static_cast<uint8_t>(to);
+    record.changedAt = atEpoch;
+    std::memcpy(record.panelID, panelID.data(), panelID.size());
+    std::memcpy(record.operatorName, operatorName.data(),
+                (std::min)(operatorName.size(), sizeof(record.operatorName) - 1));
+    record.crc = statusRecordCrc(record);
+
+    return m_log.append({record}) ? StatusChangeError::None : StatusChangeError::WriteFailed;
+}
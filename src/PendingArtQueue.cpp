@@ -0,0 +1,117 @@
+#include "PendingArtQueue.h"
+#include "PanelJournal.h"
+#include "Platform.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+// Rewrite the manifest once it holds this many more entries than pending panels
+static const long long COMPACT_SLACK_RECORDS = 1024;
+
+static uint32_t pendingRecordCrc(const PendingArtRecord& record) {
+    return journalCrc32(&record, offsetof(PendingArtRecord, crc));
+}
+
+static bool isValidPendingRecord(const PendingArtRecord& record) {
+    return record.magic == PENDING_ART_RECORD_MAGIC && record.crc == pendingRecordCrc(record);
+}
+
+// A PanelID cut short would never match a later remove(), so longer ones are refused
+static bool fitsPendingRecord(const std::string& panelID) {
+    return panelID.size() < sizeof(PendingArtRecord::panelID);
+}
+
+// panelID must fit the record; see fitsPendingRecord()
+static PendingArtRecord makePendingRecord(PendingArtOp op, const std::string& panelID, long long at) {
+    PendingArtRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.magic = PENDING_ART_RECORD_MAGIC;
+    record.op = static_cast<uint8_t>(op);
+    record.changedAt = at;
+    std::memcpy(record.panelID, panelID.data(), panelID.size());
+    record.crc = pendingRecordCrc(record);
+    return record;
+}
+
+static bool readPendingHeader(const PendingArtRecord& record, long long& generation) {
+    if (record.op != static_cast<uint8_t>(PendingArtOp::Header) || !isValidPendingRecord(record)) {
+        return false;
+    }
+    generation = record.changedAt;
+    return true;
+}
+
+static PendingArtRecord makePendingHeader(long long generation) {
+    return makePendingRecord(PendingArtOp::Header, std::string(), generation);
+}
+
+static const RecordLogFormat<PendingArtRecord> PENDING_ART_FORMAT = {isValidPendingRecord, readPendingHeader,
+                                                                     makePendingHeader};
+
+PendingArtQueue::PendingArtQueue(const std::string& manifestPath)
+    : m_log(manifestPath, PENDING_ART_FORMAT, [this](const PendingArtRecord& record) { apply(record); },
+            [this]() { m_pending.clear(); }) {
+}
+
+void PendingArtQueue::apply(const PendingArtRecord& record) {
+    std::string panelID(record.panelID, strnlen(record.panelID, sizeof(record.panelID)));
+    if (record.op == static_cast<uint8_t>(PendingArtOp::Added)) {
+        m_pending.insert(panelID);
+    } else if (record.op == static_cast<uint8_t>(PendingArtOp::Removed)) {
+        m_pending.erase(panelID);
+    }
+}
+
+void PendingArtQueue::refresh() {
+    m_log.refresh();
+}
+
+bool PendingArtQueue::add(const std::vector<std::string>& panelIDs, long long atEpoch) {
+    return change(PendingArtOp::Added, panelIDs, atEpoch);
+}
+
+bool PendingArtQueue::remove(const std::vector<std::string>& panelIDs, long long atEpoch) {
+    return change(PendingArtOp::Removed, panelIDs, atEpoch);
+}
+
+bool PendingArtQueue::change(PendingArtOp op, const std::vector<std::string>& panelIDs, long long atEpoch) {
+    if (!std::all_of(panelIDs.begin(), panelIDs.end(), fitsPendingRecord)) {
+        return false;
+    }
+
+    FileRangeLock lock(m_log.lockPath(), 0, 1);
+    if (!lock.locked()) {
+        return false;
+    }
+    m_log.refresh();
+
+    std::vector<PendingArtRecord> records;
+    std::set<std::string> seen;
+    for (const std::string& panelID : panelIDs) {
+        bool pending = m_pending.count(panelID) != 0;
+        bool wanted = op == PendingArtOp::Added ? !pending : pending;
+        if (wanted && !panelID.empty() && seen.insert(panelID).second) {
+            records.push_back(makePendingRecord(op, panelID, atEpoch));
+        }
+    }
+    // Even with nothing to record the first change creates the manifest, so a
+    // station seeding from an empty PendingArt does not seed again
+    if (!m_log.append(records)) {
+        return false;
+    }
+
+    if (m_log.records() > 2 * static_cast<long long>(m_pending.size()) + COMPACT_SLACK_RECORDS) {
+        compact();
+    }
+    return true;
+}
+
+// Rewrite the manifest with one entry per pending panel. Caller holds the lock.
+void PendingArtQueue::compact() {
+    std::vector<PendingArtRecord> live;
+    live.reserve(m_pending.size());
+    for (const std::string& panelID : m_pending) {
+        live.push_back(makePendingRecord(PendingArtOp::Added, panelID, 0));
+    }
+    m_log.compact(live);
+}
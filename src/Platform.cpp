@@ -0,0 +1,323 @@
+#include "Platform.h"
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#endif
+
+namespace fs = std::filesystem;
+
+std::string executablePath() {
+#ifdef _WIN32
+    char buffer[MAX_PATH];
+    GetModuleFileNameA(NULL, buffer, MAX_PATH);
+    return std::string(buffer);
+#else
+    // Headless builds resolve the running binary via procfs
+    std::error_code ec;
+    return fs::read_symlink("/proc/self/exe", ec).string();
+#endif
+}
+
+std::string executableDirectory() {
+    std::string exePath = executablePath();
+    size_t pos = exePath.find_last_of("\\/");
+    return (pos != std::string::npos) ? exePath.substr(0, pos) : ".";
+}
+
+std::string nativePath(const std::string& path) {
+#ifdef _WIN32
+    return path;
+#else
+    std::string native = path;
+    std::replace(native.begin(), native.end(), '\\', '/');
+    return native;
+#endif
+}
+
+#ifndef _WIN32
+// Linux builds from before paths were translated created files literally named
+// "MasterData\wolftrack_panels_master.wtj" beside the executable. Move them to
+// where they belong, unless something already lives there.
+static void moveFlatLegacyEntries(const std::string& dir) {
+    std::error_code ec;
+    std::vector<fs::path> flat;
+    for (const auto& item : fs::directory_iterator(dir, ec)) {
+        if (item.path().filename().string().find('\\') != std::string::npos) {
+            flat.push_back(item.path());
+        }
+    }
+    for (const fs::path& from : flat) {
+        fs::path to = fs::path(dir) / nativePath(from.filename().string());
+        if (!fs::exists(to, ec)) {
+            fs::create_directories(to.parent_path(), ec);
+            fs::rename(from, to, ec);
+        }
+    }
+}
+#endif
+
+// The executable's folder, looked up once per process
+static const std::string& appDirectory() {
+    static const std::string dir = []() {
+        std::string exeDir = executableDirectory();
+#ifndef _WIN32
+        moveFlatLegacyEntries(exeDir);
+#endif
+        return exeDir;
+    }();
+    return dir;
+}
+
+std::string appDataPath(const std::string& relativePath) {
+    return (fs::path(appDirectory()) / nativePath(relativePath)).string();
+}
+
+void setFileReadOnly(const std::string& path, bool readOnly) {
+#ifdef _WIN32
+    DWORD attrs = GetFileAttributesA(path.c_str());
+    if (attrs == INVALID_FILE_ATTRIBUTES) {
+        return;
+    }
+    SetFileAttributesA(path.c_str(), readOnly ? (attrs | FILE_ATTRIBUTE_READONLY)
+                                              : (attrs & ~FILE_ATTRIBUTE_READONLY));
+#else
+    std::error_code ec;
+    fs::permissions(path, fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write,
+                    readOnly ? fs::perm_options::remove : fs::perm_options::add, ec);
+#endif
+}
+
+FileWriteError appendFileDurably(const std::string& path, const char* data, size_t length) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return FileWriteError::OpenFailed;
+    }
+    DWORD written = 0;
+    if (!WriteFile(file, data, static_cast<DWORD>(length), &written, NULL) || written != length) {
+        CloseHandle(file);
+        return FileWriteError::WriteFailed;
+    }
+    bool synced = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return FileWriteError::OpenFailed;
+    }
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = ::write(fd, data + done, length - done);
+        if (n <= 0) {
+            ::close(fd);
+            return FileWriteError::WriteFailed;
+        }
+        done += static_cast<size_t>(n);
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+#endif
+    return synced ? FileWriteError::None : FileWriteError::SyncFailed;
+}
+
+bool isFileOpenByWriter(const std::string& path) {
+#ifdef _WIN32
+    // The MES keeps the file open while writing; an exclusive open fails until it closes
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return true;
+    }
+    CloseHandle(file);
+    return false;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+FileRangeLock::FileRangeLock(const std::string& path, unsigned long long offset, unsigned long long length)
+    : m_offset(offset), m_length(length) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    m_handle = file;
+    OVERLAPPED range = {};
+    range.Offset = static_cast<DWORD>(offset);
+    range.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    m_locked = LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK, 0, static_cast<DWORD>(length),
+                          static_cast<DWORD>(length >> 32), &range) != 0;
+#else
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        return;
+    }
+    struct flock range = {};
+    range.l_type = F_WRLCK;
+    range.l_whence = SEEK_SET;
+    range.l_start = static_cast<off_t>(offset);
+    range.l_len = static_cast<off_t>(length);
+#ifdef F_OFD_SETLKW
+    // Owned by this descriptor, so threads of one process exclude each other too
+    int command = F_OFD_SETLKW;
+#else
+    int command = F_SETLKW;
+#endif
+    while (::fcntl(m_fd, command, &range) != 0) {
+        if (errno != EINTR) {
+            return;
+        }
+    }
+    m_locked = true;
+#endif
+}
+
+FileRangeLock::~FileRangeLock() {
+#ifdef _WIN32
+    if (m_handle != nullptr) {
+        if (m_locked) {
+            OVERLAPPED range = {};
+            range.Offset = static_cast<DWORD>(m_offset);
+            range.OffsetHigh = static_cast<DWORD>(m_offset >> 32);
+            UnlockFileEx(m_handle, 0, static_cast<DWORD>(m_length), static_cast<DWORD>(m_length >> 32), &range);
+        }
+        CloseHandle(m_handle);
+    }
+#else
+    // Closing the descriptor releases its locks
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+}
+
+bool FileRangeLock::locked() const {
+    return m_locked;
+}
+
+bool FileRangeLock::read(unsigned long long offset, void* data, size_t length) {
+    if (!m_locked) {
+        return false;
+    }
+#ifdef _WIN32
+    OVERLAPPED at = {};
+    at.Offset = static_cast<DWORD>(offset);
+    at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD done = 0;
+    return ReadFile(m_handle, data, static_cast<DWORD>(length), &done, &at) && done == length;
+#else
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = ::pread(m_fd, static_cast<char*>(data) + done, length - done,
+                            static_cast<off_t>(offset + done));
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+#endif
+}
+
+FileWriteError FileRangeLock::write(unsigned long long offset, const void* data, size_t length) {
+    if (!m_locked) {
+        return FileWriteError::OpenFailed;
+    }
+#ifdef _WIN32
+    OVERLAPPED at = {};
+    at.Offset = static_cast<DWORD>(offset);
+    at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD done = 0;
+    if (!WriteFile(m_handle, data, static_cast<DWORD>(length), &done, &at) || done != length) {
+        return FileWriteError::WriteFailed;
+    }
+    return FlushFileBuffers(m_handle) ? FileWriteError::None : FileWriteError::SyncFailed;
+#else
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = ::pwrite(m_fd, static_cast<const char*>(data) + done, length - done,
+                             static_cast<off_t>(offset + done));
+        if (n <= 0) {
+            return FileWriteError::WriteFailed;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return ::fsync(m_fd) == 0 ? FileWriteError::None : FileWriteError::SyncFailed;
+#endif
+}
+
+DirectoryChangeNotifier::DirectoryChangeNotifier(const std::string& dir) {
+#ifdef _WIN32
+    HANDLE handle = FindFirstChangeNotificationA(dir.c_str(), FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    m_handle = (handle == INVALID_HANDLE_VALUE) ? nullptr : handle;
+#elif defined(__linux__)
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd >= 0) {
+        m_wd = inotify_add_watch(m_fd, dir.c_str(), IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE);
+    }
+#else
+    (void)dir;  // No native notifications here; callers fall back to polling
+#endif
+}
+
+DirectoryChangeNotifier::~DirectoryChangeNotifier() {
+#ifdef _WIN32
+    if (m_handle != nullptr) {
+        FindCloseChangeNotification(m_handle);
+    }
+#else
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+}
+
+bool DirectoryChangeNotifier::ok() const {
+#ifdef _WIN32
+    return m_handle != nullptr;
+#else
+    return m_fd >= 0 && m_wd >= 0;
+#endif
+}
+
+bool DirectoryChangeNotifier::wait(std::chrono::milliseconds timeout) {
+#ifdef _WIN32
+    if (WaitForSingleObject(m_handle, static_cast<DWORD>(timeout.count())) != WAIT_OBJECT_0) {
+        return false;
+    }
+    FindNextChangeNotification(m_handle);
+    return true;
+#else
+    pollfd pfd = {m_fd, POLLIN, 0};
+    if (::poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+        return false;
+    }
+    // Drain the events; they only say that something changed
+    char buffer[4096];
+    while (::read(m_fd, buffer, sizeof(buffer)) > 0) {
+    }
+    return true;
+#endif
+}
+
+const char* DirectoryChangeNotifier::name() const {
+#ifdef _WIN32
+    return "win32-change-notification";
+#else
+    return "inotify";
+#endif
+}
@@ -0,0 +1,82 @@
+#include "SerialIndex.h"
+#include <cstring>
+#include <sstream>
+
+void SerialIndex::addRecord(const PanelJournalRecord& record, long long row) {
+    std::string panelID(record.panelID, strnlen(record.panelID, sizeof(record.panelID)));
+    m_panelRows.emplace(panelID, row);
+
+    for (int i = 0; i < 24; ++i) {
+        const char* serial = record.pcbSerials[i];
+        size_t len = strnlen(serial, sizeof(record.pcbSerials[i]));
+        if (len == 0) {
+            continue;
+        }
+        // Keep the first sighting; later ones are the duplicates we report
+        m_serials.emplace(std::string(serial, len), SerialLocation{panelID, i + 1, row});
+    }
+}
+
+void SerialIndex::addPanel(const Panel& panel, long long row) {
+    m_panelRows.emplace(panel.panelID, row);
+    for (size_t i = 0; i < panel.pcbSerials.size(); ++i) {
+        if (!panel.pcbSerials[i].empty()) {
+            m_serials.emplace(panel.pcbSerials[i], SerialLocation{panel.panelID, static_cast<int>(i) + 1, row});
+        }
+    }
+}
+
+bool SerialIndex::findSerial(const std::string& serial, SerialLocation& out) const {
+    auto it = m_serials.find(serial);
+    if (it == m_serials.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
+}
+
+bool SerialIndex::findPanelRow(const std::string& panelID, long long& row) const {
+    auto it = m_panelRows.find(panelID);
+    if (it == m_panelRows.end()) {
+        return false;
+    }
+    row = it->second;
+    return true;
+}
+
+std::vector<SerialDuplicate> SerialIndex::findDuplicates(const Panel& panel) const {
+    std::vector<SerialDuplicate> duplicates;
+    std::unordered_map<std::string, int> seenInPanel;
+
+    for (size_t i = 0; i < panel.pcbSerials.size(); ++i) {
+        const std::string& serial = panel.pcbSerials[i];
+        if (serial.empty()) {
+            continue;
+        }
+        int slot = static_cast<int>(i) + 1;
+
+        SerialLocation existing;
+        if (findSerial(serial, existing)) {
+            duplicates.push_back(SerialDuplicate{serial, slot, existing});
+        } else {
+            auto seen = seenInPanel.emplace(serial, slot);
+            if (!seen.second) {
+                duplicates.push_back(SerialDuplicate{serial, slot, SerialLocation{panel.panelID, seen.first->second, -1}});
+            }
+        }
+    }
+    return duplicates;
+}
+
+std::string formatDuplicateSerials(const std::vector<SerialDuplicate>& duplicates, size_t maxLines) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < duplicates.size() && i < maxLines; ++i) {
+        const SerialDuplicate& dup = duplicates[i];
+        oss << dup.serial << " (slot " << dup.slot << ") already on "
+            << dup.existing.panelID << " slot " << dup.existing.slot << "\n";
+    }
+    if (duplicates.size() > maxLines) {
+        oss << "... and " << (duplicates.size() - maxLines) << " more\n";
+    }
+    return oss.str();
+}
@@ -0,0 +1,66 @@
+#include "SvgWriter.h"
+#include <charconv>
+#include <fstream>
+
+SvgWriter::SvgWriter(size_t initialCapacity) {
+    m_buffer.reserve(initialCapacity);
+}
+
+SvgWriter& SvgWriter::raw(std::string_view markup) {
+    m_buffer.append(markup.data(), markup.size());
+    return *this;
+}
+
+SvgWriter& SvgWriter::text(std::string_view content) {
+    // Serials and names come from MES exports; a stray '&' or '<' would break the file
+    size_t start = 0;
+    for (size_t i = 0; i < content.size(); ++i) {
+        const char* entity = nullptr;
+        switch (content[i]) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            default: continue;
+        }
+        m_buffer.append(content.data() + start, i - start);
+        m_buffer.append(entity);
+        start = i + 1;
+    }
+    m_buffer.append(content.data() + start, content.size() - start);
+    return *this;
+}
+
+SvgWriter& SvgWriter::number(long long value) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    m_buffer.append(digits, static_cast<size_t>(result.ptr - digits));
+    return *this;
+}
+
+SvgWriter& SvgWriter::rect(int x, int y, int width, int height, std::string_view attributes) {
+    raw("  <rect x=\"").number(x);
+    raw("\" y=\"").number(y);
+    raw("\" width=\"").number(width);
+    raw("\" height=\"").number(height);
+    raw("\" ").raw(attributes).raw("/>\n");
+    return *this;
+}
+
+bool SvgWriter::writeToFile(const std::string& path) const {
+    return writeWholeFile(path, m_buffer);
+}
+
+bool writeWholeFile(const std::string& path, std::string_view data) {
+    // Unbuffered, so the data goes to the OS in one write instead of being
+    // copied through the stream's own buffer
+    std::ofstream out;
+    out.rdbuf()->pubsetbuf(nullptr, 0);
+    out.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    out.close();
+    return !out.fail();
+}
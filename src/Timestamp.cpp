@@ -0,0 +1,45 @@
+#include "Timestamp.h"
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+static std::tm toLocalTime(std::time_t t) {
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    return tm;
+}
+
+std::string currentTimestamp() {
+    auto now = std::chrono::system_clock::now();
+    return epochToTimestamp(static_cast<long long>(std::chrono::system_clock::to_time_t(now)));
+}
+
+long long timestampToEpoch(const std::string& timestamp) {
+    if (timestamp.empty()) {
+        return 0;
+    }
+    std::tm tm{};
+    std::istringstream iss(timestamp);
+    iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    if (iss.fail()) {
+        return 0;
+    }
+    tm.tm_isdst = -1; // Let the C library work out daylight saving
+    std::time_t t = std::mktime(&tm);
+    return (t == static_cast<std::time_t>(-1)) ? 0 : static_cast<long long>(t);
+}
+
+std::string epochToTimestamp(long long epoch) {
+    if (epoch == 0) {
+        return "";
+    }
+    std::tm tm = toLocalTime(static_cast<std::time_t>(epoch));
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return oss.str();
+}
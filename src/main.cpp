@@ -7,9 +7,15 @@
 #include <commctrl.h>
 #include "Panel.h"
 #include "MasterData.h"
+#include "LedgerIndex.h"
 #include "Gui.h"
 #include "SessionState.h"
 #include "Config.h"
+#include "BatchImport.h"
+#include "ArtworkPipeline.h"
+#include "Metrics.h"
+#include "AppPaths.h"
+#include "LaserJob.h"
 
 namespace fs = std::filesystem;
 
@@ -23,16 +29,8 @@ static HWND g_hDialogWindow = NULL;
 static bool g_dialogClosed = false;
 
 // STAGE 1 UPGRADE: Helper functions for operator persistence
-static std::string getExeDirectory() {
-    char buffer[MAX_PATH];
-    GetModuleFileNameA(NULL, buffer, MAX_PATH);
-    std::string exePath(buffer);
-    size_t pos = exePath.find_last_of("\\/");
-    return (pos != std::string::npos) ? exePath.substr(0, pos) : ".";
-}
-
 static std::string loadOperatorFromSettings() {
-    std::string settingsPath = getExeDirectory() + "\\settings.ini";
+    std::string settingsPath = appPaths().settingsFile;
     std::ifstream file(settingsPath);
     if (file.is_open()) {
         std::string line;
@@ -46,7 +44,7 @@ static std::string loadOperatorFromSettings() {
 }
 
 static void saveOperatorToSettings(const std::string& operatorName) {
-    std::string settingsPath = getExeDirectory() + "\\settings.ini";
+    std::string settingsPath = appPaths().settingsFile;
     std::ofstream file(settingsPath);
     if (file.is_open()) {
         file << "operator=" << operatorName << "\n";
@@ -200,13 +198,71 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     FreeConsole();
     
     // STAGE 1 UPGRADE: Ensure folder structure exists at startup
-    std::string exeDir = getExeDirectory();
-    fs::create_directories(fs::path(exeDir) / WolfTrackConfig::INPUT_PANELS_ROOT);
-    fs::create_directories(fs::path(exeDir) / WolfTrackConfig::INPUT_PANELS_ARCHIVE);
-    fs::create_directories(fs::path(exeDir) / WolfTrackConfig::PENDING_ART_ROOT);
-    fs::create_directories(fs::path(exeDir) / WolfTrackConfig::COMPLETED_ART_ROOT);
-    fs::create_directories(fs::path(exeDir) / "MasterData");
+    // (this also primes ensureDirectory, so imports skip the mkdirs)
+    const AppPaths& paths = appPaths();
+    ensureDirectory(paths.inputPanels);
+    ensureDirectory(paths.inputArchive);
+    ensureDirectory(paths.pendingArt);
+    ensureDirectory(paths.completedArt);
+    ensureDirectory(paths.laserJobs);
+    ensureDirectory(paths.masterDir);
+
+    // Keep the stage latency file current while the program runs
+    startMetricsDump(paths.metricsFile,
+                     std::chrono::seconds(WolfTrackConfig::METRICS_DUMP_SECONDS));
     
+    // Headless batch mode: drain InputPanels in one pass using the saved operator,
+    // write the summary next to the archive and exit without showing any window
+    if (lpCmdLine != NULL && std::string(lpCmdLine).find("--batch") != std::string::npos) {
+        g_currentOperator = loadOperatorFromSettings();
+        BatchImportSummary summary = runBatchImport(paths.inputPanels);
+        checkpointLedgerIndex();
+
+        std::ofstream log(fs::path(paths.inputArchive) / "batch_import_summary.txt");
+        if (log.is_open()) {
+            log << formatBatchImportSummary(summary);
+        }
+        stopMetricsDump();
+        return summary.filesFailed == 0 ? 0 : 1;
+    }
+
+    // Headless artwork regeneration for every panel in the ledger
+    if (lpCmdLine != NULL && std::string(lpCmdLine).find("--regenerate-art") != std::string::npos) {
+        g_currentOperator = loadOperatorFromSettings();
+        std::vector<ArtworkStageTiming> timings;
+        int failed = regenerateAllArtwork(&timings);
+
+        std::ofstream log(fs::path(paths.pendingArt) / "regenerate_art_summary.txt");
+        if (log.is_open()) {
+            log << "Panels failed: " << failed << "\n" << formatArtworkTimings(timings);
+        }
+        stopMetricsDump();
+        return failed == 0 ? 0 : 1;
+    }
+
+    // Headless laser job: nest every ReadyForLaser panel onto as few bed-sized
+    // job files as possible, so one laser run handles many panels
+    if (lpCmdLine != NULL && std::string(lpCmdLine).find("--laser-job") != std::string::npos) {
+        g_currentOperator = loadOperatorFromSettings();
+        LaserJobResult job = buildReadyForLaserJob(g_currentOperator);
+
+        std::ofstream log(fs::path(paths.laserJobs) / "laser_job_summary.txt");
+        if (log.is_open()) {
+            log << "Panels placed: " << job.placedPanels.size() << "\n";
+            for (const std::string& path : job.jobPaths) {
+                log << "Job file: " << path << "\n";
+            }
+            for (const std::string& id : job.skippedPanels) {
+                log << "Skipped: " << id << "\n";
+            }
+        }
+        stopMetricsDump();
+        return job.skippedPanels.empty() ? 0 : 1;
+    }
+    
+    // Build the serial search index in the background while the operator signs in
+    preloadMasterSearchIndex();
+
     // Show GUI dialog for operator name
     showOperatorNameDialog();
 
@@ -218,9 +274,14 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     p.createdAt = "";
     p.laseredAt = "";
     p.sourceFile = "";
+    p.operatorName = "";
 
     // Show GUI with no panel loaded
     runPanelViewerGui(p);
 
+    // Persist ledger stats folded in since the last checkpoint
+    checkpointLedgerIndex();
+    stopMetricsDump();
+
     return 0;
 }
@@ -0,0 +1,385 @@
+// Round-trip check for the ECC200 DataMatrix encoder, e.g.
+//   DataMatrixCheck                       Published vectors plus a payload sweep
+//   DataMatrixCheck WT-P-00123            Also round-trip this text and print the symbol
+// Every symbol is read back by the reference reader below, which shares no code
+// with the encoder: it checks the finder patterns, reads codewords with its own
+// walk over the mapping matrix, checks every Reed-Solomon block and decodes the
+// ASCII codewords back to text. Exits 0 only if all checks pass.
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "DataMatrix.h"
+
+// ISO/IEC 16022 symbol attributes for the square sizes
+struct ReferenceSize {
+    int size;
+    int regionSize;
+    int regions;
+    int dataCodewords;
+    int eccCodewords;
+    int blocks;
+};
+
+static const ReferenceSize REFERENCE_SIZES[] = {
+    {10, 8, 1, 3, 5, 1},        {12, 10, 1, 5, 7, 1},       {14, 12, 1, 8, 10, 1},
+    {16, 14, 1, 12, 12, 1},     {18, 16, 1, 18, 14, 1},     {20, 18, 1, 22, 18, 1},
+    {22, 20, 1, 30, 20, 1},     {24, 22, 1, 36, 24, 1},     {26, 24, 1, 44, 28, 1},
+    {32, 14, 2, 62, 36, 1},     {36, 16, 2, 86, 42, 1},     {40, 18, 2, 114, 48, 1},
+    {44, 20, 2, 144, 56, 1},    {48, 22, 2, 174, 68, 1},    {52, 24, 2, 204, 84, 2},
+    {64, 14, 4, 280, 112, 2},   {72, 16, 4, 368, 144, 4},   {80, 18, 4, 456, 192, 4},
+    {88, 20, 4, 576, 224, 4},   {96, 22, 4, 696, 272, 4},   {104, 24, 4, 816, 336, 6},
+    {120, 18, 6, 1050, 408, 6}, {132, 20, 6, 1304, 496, 8}, {144, 22, 6, 1558, 620, 10},
+};
+
+static const ReferenceSize* referenceSize(int size) {
+    for (const ReferenceSize& ref : REFERENCE_SIZES) {
+        if (ref.size == size) {
+            return &ref;
+        }
+    }
+    return nullptr;
+}
+
+// ISO/IEC 16022 worked example: "123456" in a 10x10 symbol
+static const uint8_t ISO_123456_CODEWORDS[] = {142, 164, 186, 114, 25, 5, 88, 102};
+
+// The 10x10 "123456" symbol, top row first; '#' is dark. Confirmed with the
+// reference reader when recorded, so any change to placement shows up here.
+static const char* const SYMBOL_123456[] = {
+    "#.#.#.#.#.",
+    "##..#.##.#",
+    "##.....#..",
+    "##...###.#",
+    "##....#...",
+    "#.....####",
+    "###.##....",
+    "####.##..#",
+    "#..###.#..",
+    "##########",
+};
+
+// GF(256) arithmetic with the DataMatrix field polynomial 0x12D
+class Galois {
+public:
+    Galois() {
+        int x = 1;
+        for (int i = 0; i < 255; ++i) {
+            m_exp[i] = x;
+            m_log[x] = i;
+            x <<= 1;
+            if (x >= 256) {
+                x ^= 0x12D;
+            }
+        }
+    }
+    int multiply(int a, int b) const {
+        return (a == 0 || b == 0) ? 0 : m_exp[(m_log[a] + m_log[b]) % 255];
+    }
+    int power(int exponent) const { return m_exp[exponent % 255]; }
+
+private:
+    int m_exp[255];
+    int m_log[256] = {};
+};
+
+static const Galois GALOIS;
+
+// Reads codeword bits out of the mapping matrix, marking each module once
+class CodewordReader {
+public:
+    CodewordReader(const std::vector<uint8_t>& bits, int rows, int cols)
+        : m_bits(bits), m_read(bits.size(), 0), m_rows(rows), m_cols(cols) {}
+
+    std::vector<uint8_t> readAll(bool& everyModuleReadOnce) {
+        std::vector<uint8_t> codewords;
+        int row = 4;
+        int col = 0;
+        bool corner1 = false, corner2 = false, corner3 = false, corner4 = false;
+        do {
+            if (row == m_rows && col == 0 && !corner1) {
+                codewords.push_back(readCorner({{m_rows - 1, 0}, {m_rows - 1, 1}, {m_rows - 1, 2}, {0, m_cols - 2},
+                                                {0, m_cols - 1}, {1, m_cols - 1}, {2, m_cols - 1}, {3, m_cols - 1}}));
+                row -= 2;
+                col += 2;
+                corner1 = true;
+            } else if (row == m_rows - 2 && col == 0 && (m_cols & 3) != 0 && !corner2) {
+                codewords.push_back(readCorner({{m_rows - 3, 0}, {m_rows - 2, 0}, {m_rows - 1, 0}, {0, m_cols - 4},
+                                                {0, m_cols - 3}, {0, m_cols - 2}, {0, m_cols - 1}, {1, m_cols - 1}}));
+                row -= 2;
+                col += 2;
+                corner2 = true;
+            } else if (row == m_rows + 4 && col == 2 && (m_cols & 7) == 0 && !corner3) {
+                codewords.push_back(readCorner({{m_rows - 1, 0}, {m_rows - 1, m_cols - 1}, {0, m_cols - 3}, {0, m_cols - 2},
+                                                {0, m_cols - 1}, {1, m_cols - 3}, {1, m_cols - 2}, {1, m_cols - 1}}));
+                row -= 2;
+                col += 2;
+                corner3 = true;
+            } else if (row == m_rows - 2 && col == 0 && (m_cols & 7) == 4 && !corner4) {
+                codewords.push_back(readCorner({{m_rows - 3, 0}, {m_rows - 2, 0}, {m_rows - 1, 0}, {0, m_cols - 2},
+                                                {0, m_cols - 1}, {1, m_cols - 1}, {2, m_cols - 1}, {3, m_cols - 1}}));
+                row -= 2;
+                col += 2;
+                corner4 = true;
+            } else {
+                do {
+                    if (row < m_rows && col >= 0 && !m_read[row * m_cols + col]) {
+                        codewords.push_back(readUtah(row, col));
+                    }
+                    row -= 2;
+                    col += 2;
+                } while (row >= 0 && col < m_cols);
+                row += 1;
+                col += 3;
+                do {
+                    if (row >= 0 && col < m_cols && !m_read[row * m_cols + col]) {
+                        codewords.push_back(readUtah(row, col));
+                    }
+                    row += 2;
+                    col -= 2;
+                } while (row < m_rows && col >= 0);
+                row += 3;
+                col += 1;
+            }
+        } while (row < m_rows || col < m_cols);
+
+        // Only the fixed bottom-right pattern may be left unread, and no module twice
+        everyModuleReadOnce = !m_readTwice;
+        for (int i = 0; i < m_rows * m_cols; ++i) {
+            bool fixedCorner = i == m_rows * m_cols - 1 || i == m_rows * m_cols - 2 ||
+                               i == m_rows * m_cols - m_cols - 1 || i == m_rows * m_cols - m_cols - 2;
+            if (!m_read[i] && !fixedCorner) {
+                everyModuleReadOnce = false;
+            }
+        }
+        return codewords;
+    }
+
+private:
+    struct Cell {
+        int row;
+        int col;
+    };
+
+    int readModule(int row, int col) {
+        if (row < 0) {
+            row += m_rows;
+            col += 4 - ((m_rows + 4) & 7);
+        }
+        if (col < 0) {
+            col += m_cols;
+            row += 4 - ((m_cols + 4) & 7);
+        }
+        int index = row * m_cols + col;
+        if (m_read[index]) {
+            m_readTwice = true;
+        }
+        m_read[index] = 1;
+        return m_bits[index];
+    }
+
+    uint8_t readUtah(int row, int col) {
+        const Cell cells[8] = {{row - 2, col - 2}, {row - 2, col - 1}, {row - 1, col - 2}, {row - 1, col - 1},
+                               {row - 1, col}, {row, col - 2}, {row, col - 1}, {row, col}};
+        int value = 0;
+        for (const Cell& cell : cells) {
+            value = (value << 1) | readModule(cell.row, cell.col);
+        }
+        return static_cast<uint8_t>(value);
+    }
+
+    uint8_t readCorner(const std::vector<Cell>& cells) {
+        int value = 0;
+        for (const Cell& cell : cells) {
+            value = (value << 1) | readModule(cell.row, cell.col);
+        }
+        return static_cast<uint8_t>(value);
+    }
+
+    const std::vector<uint8_t>& m_bits;
+    std::vector<uint8_t> m_read;
+    int m_rows;
+    int m_cols;
+    bool m_readTwice = false;
+};
+
+// Decode a symbol back to its text; fills why on failure
+static bool readSymbol(const DataMatrixSymbol& symbol, std::string& text, std::string& why) {
+    const ReferenceSize* ref = referenceSize(symbol.size);
+    if (ref == nullptr || symbol.modules.size() != static_cast<size_t>(symbol.size) * symbol.size) {
+        why = "not a square ECC200 size";
+        return false;
+    }
+
+    // Finder patterns around every data region, and the data modules inside them
+    int block = ref->regionSize + 2;
+    int mapSize = ref->regionSize * ref->regions;
+    std::vector<uint8_t> bits(static_cast<size_t>(mapSize) * mapSize);
+    for (int row = 0; row < symbol.size; ++row) {
+        for (int col = 0; col < symbol.size; ++col) {
+            int r = row % block;
+            int c = col % block;
+            bool dark = symbol.dark(row, col);
+            bool expected;
+            if (c == 0 || r == block - 1) {
+                expected = true;
+            } else if (r == 0) {
+                expected = c % 2 == 0;
+            } else if (c == block - 1) {
+                expected = r % 2 == 1;
+            } else {
+                bits[((row / block) * ref->regionSize + r - 1) * mapSize + (col / block) * ref->regionSize + c - 1] = dark;
+                continue;
+            }
+            if (dark != expected) {
+                why = "finder pattern broken at row " + std::to_string(row) + " col " + std::to_string(col);
+                return false;
+            }
+        }
+    }
+
+    bool readOnce = false;
+    std::vector<uint8_t> codewords = CodewordReader(bits, mapSize, mapSize).readAll(readOnce);
+    if (!readOnce || static_cast<int>(codewords.size()) != ref->dataCodewords + ref->eccCodewords) {
+        why = "codeword placement does not cover the mapping matrix";
+        return false;
+    }
+
+    // Each interleaved block, data then check codewords, must be a codeword of
+    // the code whose generator has roots a^1..a^n: every syndrome is zero
+    int eccPerBlock = ref->eccCodewords / ref->blocks;
+    for (int b = 0; b < ref->blocks; ++b) {
+        std::vector<int> blockWords;
+        for (int i = b; i < ref->dataCodewords; i += ref->blocks) {
+            blockWords.push_back(codewords[i]);
+        }
+        for (int i = b; i < ref->eccCodewords; i += ref->blocks) {
+            blockWords.push_back(codewords[ref->dataCodewords + i]);
+        }
+        for (int root = 1; root <= eccPerBlock; ++root) {
+            int syndrome = 0;
+            for (int word : blockWords) {
+                syndrome = GALOIS.multiply(syndrome, GALOIS.power(root)) ^ word;
+            }
+            if (syndrome != 0) {
+                why = "Reed-Solomon block " + std::to_string(b) + " has a non-zero syndrome";
+                return false;
+            }
+        }
+    }
+
+    // ASCII encodation
+    text.clear();
+    for (int i = 0; i < ref->dataCodewords; ++i) {
+        int cw = codewords[i];
+        if (cw >= 1 && cw <= 128) {
+            text += static_cast<char>(cw - 1);
+        } else if (cw == 129) {
+            break;
+        } else if (cw >= 130 && cw <= 229) {
+            text += static_cast<char>('0' + (cw - 130) / 10);
+            text += static_cast<char>('0' + (cw - 130) % 10);
+        } else if (cw == 235 && i + 1 < ref->dataCodewords) {
+            text += static_cast<char>(codewords[++i] + 127);
+        } else {
+            why = "codeword " + std::to_string(cw) + " is not ASCII encodation";
+            return false;
+        }
+    }
+    return true;
+}
+
+static int s_failures = 0;
+
+static void fail(const std::string& what) {
+    std::fprintf(stderr, "FAIL %s\n", what.c_str());
+    s_failures++;
+}
+
+// Encode, read back and compare; expectedSize 0 accepts any size
+static void roundTrip(const std::string& text, int expectedSize, bool print = false) {
+    DataMatrixSymbol symbol;
+    if (!encodeDataMatrix(text, symbol)) {
+        fail("encode \"" + text.substr(0, 40) + "\" (" + std::to_string(text.size()) + " bytes)");
+        return;
+    }
+    std::string decoded;
+    std::string why;
+    if (!readSymbol(symbol, decoded, why)) {
+        fail(std::to_string(symbol.size) + "x" + std::to_string(symbol.size) + ": " + why);
+    } else if (decoded != text) {
+        fail(std::to_string(symbol.size) + "x" + std::to_string(symbol.size) + ": read back different text");
+    } else if (expectedSize != 0 && symbol.size != expectedSize) {
+        fail(std::to_string(text.size()) + " bytes went into " + std::to_string(symbol.size) +
+             "x" + std::to_string(symbol.size) + ", expected " + std::to_string(expectedSize));
+    }
+    if (print) {
+        for (int row = 0; row < symbol.size; ++row) {
+            for (int col = 0; col < symbol.size; ++col) {
+                std::putchar(symbol.dark(row, col) ? '#' : '.');
+            }
+            std::putchar('\n');
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    // Published codewords
+    int size = 0;
+    std::vector<uint8_t> codewords;
+    if (!encodeDataMatrixCodewords("123456", size, codewords) || size != 10 ||
+        codewords != std::vector<uint8_t>(std::begin(ISO_123456_CODEWORDS), std::end(ISO_123456_CODEWORDS))) {
+        fail("\"123456\" codewords differ from ISO/IEC 16022");
+    }
+
+    // Recorded modules
+    DataMatrixSymbol symbol;
+    if (!encodeDataMatrix("123456", symbol) || symbol.size != 10) {
+        fail("\"123456\" is not a 10x10 symbol");
+    } else {
+        for (int row = 0; row < 10; ++row) {
+            for (int col = 0; col < 10; ++col) {
+                if (symbol.dark(row, col) != (SYMBOL_123456[row][col] == '#')) {
+                    fail("\"123456\" module row " + std::to_string(row) + " col " + std::to_string(col));
+                }
+            }
+        }
+        // The reader must notice damage, or the round trips below prove nothing
+        symbol.modules[4 * 10 + 4] ^= 1;
+        std::string decoded;
+        std::string why;
+        if (readSymbol(symbol, decoded, why)) {
+            fail("reader accepted a symbol with a flipped module");
+        }
+    }
+
+    // Fill every size exactly, with letters, digit pairs and Upper Shift bytes
+    for (const ReferenceSize& ref : REFERENCE_SIZES) {
+        roundTrip(std::string(ref.dataCodewords, 'A'), ref.size);
+        roundTrip(std::string(ref.dataCodewords * 2, '7'), ref.size);
+        roundTrip(std::string(ref.dataCodewords / 2, static_cast<char>(0xC4)), ref.size);
+        std::string mixed;
+        for (int i = 0; static_cast<int>(mixed.size()) < ref.dataCodewords - 1; ++i) {
+            mixed += static_cast<char>(' ' + (i * 7) % 95);
+        }
+        roundTrip(mixed, ref.size);
+    }
+    DataMatrixSymbol tooBig;
+    if (encodeDataMatrix(std::string(1559, 'A'), tooBig)) {
+        fail("1559 codewords accepted; 144x144 holds 1558");
+    }
+
+    // Label payloads as the panels use them
+    roundTrip("WT-P-00001", 14);
+    std::string withSerials = "WT-P-00123";
+    for (int i = 1; i <= 24; ++i) {
+        withSerials += ";SN" + std::to_string(240000 + i);
+    }
+    roundTrip(withSerials, 0);
+
+    for (int i = 1; i < argc; ++i) {
+        roundTrip(argv[i], 0, true);
+    }
+
+    std::printf("%s\n", s_failures == 0 ? "PASS" : "FAIL");
+    return s_failures == 0 ? 0 : 1;
+}
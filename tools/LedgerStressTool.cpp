@@ -0,0 +1,219 @@
+// Multi-station stress check for the shared master ledger, e.g.
+//   LedgerStressTool                              4 stations x 500 panels
+//   LedgerStressTool --stations 8 --panels 2000 --threads 4 --keep
+// Copies this program into one folder under --work and starts every station
+// there at once, so they share one ledger the way stations on a network share
+// do. Each station reserves PanelIDs and appends panels as fast as it can.
+// Afterwards the ledger must hold every panel exactly once: no PanelID twice,
+// record numbers 0..N-1 with no gaps, and each station's panels all present.
+// Exits 0 only if all checks pass.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "LedgerSegments.h"
+#include "MasterData.h"
+#include "PanelJournal.h"
+#include "Platform.h"
+#include "SessionState.h"
+
+namespace fs = std::filesystem;
+
+// Written next to the shared copy; a station refuses to touch a folder without it
+static const char* CHILD_MARKER = "stress_child.marker";
+
+// One station: reserve an ID and append a panel, panelsPerStation times, from
+// a few threads so in-process reservation is exercised as well
+static int runStation(int station, int panels, int threads) {
+    if (!fs::exists(appDataPath(CHILD_MARKER))) {
+        std::fprintf(stderr, "--station only runs in a folder prepared by the stress driver\n");
+        return 2;
+    }
+    g_currentOperator = "station" + std::to_string(station);
+    if (!ensureMasterJournalExists()) {
+        std::fprintf(stderr, "station %d: the master journal could not be created\n", station);
+        return 1;
+    }
+
+    std::vector<int> failures(static_cast<size_t>(threads), 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([station, panels, threads, t, &failures]() {
+            for (int i = t; i < panels; i += threads) {
+                Panel panel;
+                panel.panelID = generateNextPanelID();
+                if (panel.panelID.empty()) {
+                    failures[static_cast<size_t>(t)]++;
+                    continue;
+                }
+                panel.panelNumber = panel.panelID;
+                // The serial says who wrote the panel, so the driver can count per station
+                char serial[32];
+                std::snprintf(serial, sizeof(serial), "S%02d-%08d", station, i);
+                panel.pcbSerials[0] = serial;
+                panel.status = PanelStatus::Detected;
+                if (appendPanelToMaster(panel) != LedgerError::None) {
+                    failures[static_cast<size_t>(t)]++;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    int failed = 0;
+    for (int f : failures) {
+        failed += f;
+    }
+    if (failed > 0) {
+        std::fprintf(stderr, "station %d: %d panel(s) failed\n", station, failed);
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+// Replay the shared ledger and check it; prints what is wrong
+static bool verifyLedger(const fs::path& dir, int stations, int panels) {
+    std::string journalPath = (dir / nativePath(MASTER_JOURNAL_PATH)).string();
+    std::string segmentsDir = (dir / nativePath(LEDGER_SEGMENTS_DIR)).string();
+
+    std::unordered_set<std::string> ids;
+    std::unordered_set<std::string> serials;
+    std::unordered_map<std::string, int> perStation;
+    long long duplicateIds = 0;
+    long long duplicateSerials = 0;
+    long long sequenceGaps = 0;
+    long long count = replayLedger(journalPath, segmentsDir,
+        [&](const PanelJournalRecord& record, long long row) {
+            Panel panel = journalRecordToPanel(record);
+            if (!ids.insert(panel.panelID).second) {
+                std::fprintf(stderr, "duplicate PanelID %s at record %lld\n", panel.panelID.c_str(), row);
+                duplicateIds++;
+            }
+            if (!serials.insert(panel.pcbSerials[0]).second) {
+                duplicateSerials++;
+            }
+            if (static_cast<long long>(record.sequence) != row) {
+                sequenceGaps++;
+            }
+            perStation[panel.pcbSerials[0].substr(0, 3)]++;
+        });
+
+    long long expected = static_cast<long long>(stations) * panels;
+    bool ok = true;
+    std::printf("records %lld (expected %lld), distinct PanelIDs %zu\n", count, expected, ids.size());
+    if (count != expected) {
+        std::fprintf(stderr, "ledger holds %lld records, expected %lld\n", count, expected);
+        ok = false;
+    }
+    if (duplicateIds > 0 || duplicateSerials > 0) {
+        std::fprintf(stderr, "%lld duplicate PanelID(s), %lld panel(s) written twice\n", duplicateIds, duplicateSerials);
+        ok = false;
+    }
+    if (sequenceGaps > 0) {
+        std::fprintf(stderr, "%lld record(s) out of sequence\n", sequenceGaps);
+        ok = false;
+    }
+    for (int s = 0; s < stations; ++s) {
+        char key[8];
+        std::snprintf(key, sizeof(key), "S%02d", s);
+        if (perStation[key] != panels) {
+            std::fprintf(stderr, "station %d: %d of %d panels in the ledger\n", s, perStation[key], panels);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static int usage() {
+    std::fprintf(stderr, "usage: LedgerStressTool [--stations N] [--panels N] [--threads N] "
+                         "[--work DIR] [--keep]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    int stations = 4;
+    int panels = 500;
+    int threads = 2;
+    fs::path workDir = fs::temp_directory_path() / "wolftrack_stress";
+    bool keep = false;
+    int station = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stations" && i + 1 < argc) {
+            stations = std::atoi(argv[++i]);
+        } else if (arg == "--panels" && i + 1 < argc) {
+            panels = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--work" && i + 1 < argc) {
+            workDir = argv[++i];
+        } else if (arg == "--keep") {
+            keep = true;
+        } else if (arg == "--station" && i + 1 < argc) {
+            station = std::atoi(argv[++i]);
+        } else {
+            return usage();
+        }
+    }
+    if (stations < 1 || stations > 99 || panels < 1 || threads < 1) {
+        return usage();
+    }
+    if (station >= 0) {
+        return runStation(station, panels, threads);
+    }
+
+    // One shared folder, like stations running from the same network share
+    std::error_code ec;
+    fs::remove_all(workDir, ec);
+    fs::create_directories(workDir);
+    fs::path self(executablePath());
+    fs::path child = workDir / self.filename();
+    fs::copy_file(self, child, fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+        std::fprintf(stderr, "could not copy %s to %s\n", self.string().c_str(), workDir.string().c_str());
+        return 1;
+    }
+    std::ofstream(workDir / CHILD_MARKER) << "LedgerStressTool work folder\n";
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> statuses(static_cast<size_t>(stations), -1);
+    std::vector<std::thread> launchers;
+    for (int s = 0; s < stations; ++s) {
+        launchers.emplace_back([&, s]() {
+            std::string command = "\"" + child.string() + "\" --station " + std::to_string(s) +
+                                  " --panels " + std::to_string(panels) + " --threads " + std::to_string(threads);
+#ifdef _WIN32
+            command = "\"" + command + "\"";  // cmd.exe strips the outer pair
+#endif
+            statuses[static_cast<size_t>(s)] = std::system(command.c_str());
+        });
+    }
+    for (std::thread& launcher : launchers) {
+        launcher.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool ok = true;
+    for (int s = 0; s < stations; ++s) {
+        if (statuses[static_cast<size_t>(s)] != 0) {
+            std::fprintf(stderr, "station %d exited with status %d\n", s, statuses[static_cast<size_t>(s)]);
+            ok = false;
+        }
+    }
+    std::printf("%d stations x %d panels (%d threads each) in %.2f s\n", stations, panels, threads, seconds);
+    ok = verifyLedger(workDir, stations, panels) && ok;
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+
+    if (!keep) {
+        fs::remove_all(workDir, ec);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,537 @@
+// Reproducible benchmarks for the MasterData module, e.g.
+//   MasterDataBench                               1k, 10k and 100k row ledgers
+//   MasterDataBench --rows 1000,1000000 --out bench.json
+// Each ledger size runs in a copy of this program placed in its own folder
+// under --work, because MasterData keeps its files next to the executable and
+// caches ledger state for the life of the process. Results go to --out as JSON.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Config.h"
+#include "LedgerIndex.h"
+#include "LedgerSegments.h"
+#include "LedgerWriter.h"
+#include "MasterData.h"
+#include "PackedPanel.h"
+#include "PanelJournal.h"
+#include "Platform.h"
+#include "SessionState.h"
+#include "SvgWriter.h"
+#include "Timestamp.h"
+
+namespace fs = std::filesystem;
+
+// Rows written per journal append while generating; each chunk is rolled into
+// closed segments straight away so memory stays flat up to 10M rows
+static const long long GENERATE_CHUNK_ROWS = 50000;
+
+// Generated ledgers cover this many months ending now, like a plant that has
+// been running for two years
+static const int HISTORY_MONTHS = 24;
+
+// Size of the input file for the parser comparison and of the in-memory SVG batch
+static const int PARSE_CSV_ROWS = 10000;
+static const int SVG_BATCH_PANELS = 10000;
+
+// Panels held in memory for the packed-store comparison
+static const int MEMORY_PANELS = 100000;
+
+// Written next to each child copy; a child refuses to touch a folder without it
+static const char* CHILD_MARKER = "bench_child.marker";
+
+// Timings of one operation
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double totalMs;
+    double meanUs;
+    double p50Us;
+    double p99Us;
+    double maxUs;
+};
+
+// Run op(i) for i in [0, iterations) and time every call
+static BenchResult timeEach(const std::string& name, long long iterations, const std::function<void(long long)>& op) {
+    std::vector<double> micros;
+    micros.reserve(static_cast<size_t>(iterations));
+    for (long long i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        op(i);
+        micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    BenchResult result = {name, iterations, 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (micros.empty()) {
+        return result;
+    }
+    double total = 0.0;
+    for (double us : micros) {
+        total += us;
+    }
+    std::sort(micros.begin(), micros.end());
+    result.totalMs = total / 1000.0;
+    result.meanUs = total / static_cast<double>(micros.size());
+    result.p50Us = micros[(micros.size() - 1) / 2];
+    result.p99Us = micros[(micros.size() - 1) * 99 / 100];
+    result.maxUs = micros.back();
+    return result;
+}
+
+static std::string resultsToJson(const std::vector<BenchResult>& results, const std::string& indent) {
+    std::ostringstream out;
+    out << "[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << indent << "  {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"total_ms\": " << r.totalMs << ", \"mean_us\": " << r.meanUs << ", \"p50_us\": " << r.p50Us
+            << ", \"p99_us\": " << r.p99Us << ", \"max_us\": " << r.maxUs << "}";
+    }
+    out << "\n" << indent << "]";
+    return out.str();
+}
+
+static void printResults(const std::string& heading, const std::vector<BenchResult>& results) {
+    std::printf("%s\n", heading.c_str());
+    for (const BenchResult& r : results) {
+        std::printf("  %-22s %8lld x  p50 %12.1f us  p99 %12.1f us  total %10.1f ms\n", r.name.c_str(),
+                    r.iterations, r.p50Us, r.p99Us, r.totalMs);
+    }
+    std::fflush(stdout);
+}
+
+// A panel as the MES would send it. Serials are prefix + a number unique per
+// panel and slot, so generated ledgers never trip the duplicate-serial check.
+static Panel syntheticPanel(long long index, const std::string& serialPrefix, std::mt19937_64& rng) {
+    static const char* operators[] = {"Christopher", "Julian", "Maria", "Sam", "Priya"};
+    Panel panel;
+    panel.panelID = formatPanelId(static_cast<int>(index + 1));
+    panel.panelNumber = panel.panelID;
+
+    // Most panels are full; a few shipped short
+    int filled = (rng() % 100 < 8) ? static_cast<int>(1 + rng() % 24) : 24;
+    for (int slot = 0; slot < filled; ++slot) {
+        char serial[32];
+        std::snprintf(serial, sizeof(serial), "%s%010lld", serialPrefix.c_str(), index * 24 + slot);
+        panel.pcbSerials[slot] = serial;
+    }
+    panel.status = (rng() % 10 < 9) ? PanelStatus::Lasered : PanelStatus::Detected;
+    panel.operatorName = operators[rng() % 5];
+    panel.sourceFile = "InputPanels\\mes_export_" + std::to_string(index / 500) + ".csv";
+    return panel;
+}
+
+// Write a ledger of rows panels next to the executable: closed monthly
+// segments for the history and the journal for the current month
+static bool generateLedger(long long rows, uint64_t seed) {
+    std::string journalPath = appDataPath(MASTER_JOURNAL_PATH);
+    std::string segmentsDir = appDataPath(LEDGER_SEGMENTS_DIR);
+    fs::create_directories(appDataPath("MasterData"));
+
+    std::mt19937_64 rng(seed);
+    long long now = timestampToEpoch(currentTimestamp());
+    long long span = static_cast<long long>(HISTORY_MONTHS) * 30 * 24 * 3600;
+    long long currentMonth = timestampToEpoch(currentTimestamp().substr(0, 8) + "01 00:00:00");
+
+    std::vector<PanelJournalRecord> records;
+    for (long long first = 0; first < rows; first += GENERATE_CHUNK_ROWS) {
+        long long count = (std::min)(GENERATE_CHUNK_ROWS, rows - first);
+        records.resize(static_cast<size_t>(count));
+        for (long long i = 0; i < count; ++i) {
+            Panel panel = syntheticPanel(first + i, "SN", rng);
+            panel.createdAt = epochToTimestamp(now - span + (first + i) * span / rows);
+            if (!panelToJournalRecord(panel, static_cast<uint32_t>(first + i), records[static_cast<size_t>(i)])) {
+                return false;
+            }
+        }
+        if (appendDurably(journalPath, reinterpret_cast<const char*>(records.data()),
+                          records.size() * sizeof(PanelJournalRecord)) != LedgerError::None) {
+            return false;
+        }
+        // Move finished months out of the journal, as the application does on startup
+        if (records.front().createdAt < currentMonth && rollLedgerSegments(journalPath, segmentsDir, now) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// An input CSV in the MES layout: BOM, PanelNumber header, one row per panel
+static bool writeInputCsv(const std::string& path, const std::vector<Panel>& panels) {
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out << "\xEF\xBB\xBF" << "PanelNumber";
+    for (int i = 1; i <= 24; ++i) {
+        out << ",PCB" << i;
+    }
+    out << "\n";
+    for (const Panel& panel : panels) {
+        out << panel.panelNumber;
+        for (const std::string& serial : panel.pcbSerials) {
+            out << "," << serial;
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+// The getline/stringstream splitter input files were read with before
+// PanelCsvReader, kept here to compare against
+static bool legacyParsePanelsCsv(const std::string& csvPath, std::vector<Panel>& outPanels) {
+    std::ifstream file(csvPath);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line)) {
+        return false;
+    }
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            while (!field.empty() && (field.back() == '\r' || field.back() == ' ')) {
+                field.pop_back();
+            }
+            while (!field.empty() && field.front() == ' ') {
+                field.erase(field.begin());
+            }
+            fields.push_back(field);
+        }
+        // getline drops a trailing empty field, so a short panel comes up one
+        // field light; the old code rejected those, here they are padded
+        if (line.find(',') == std::string::npos) {
+            return false;
+        }
+        fields.resize((std::max)(fields.size(), static_cast<size_t>(25)));
+        Panel panel;
+        panel.panelID = fields[0];
+        panel.panelNumber = fields[0];
+        for (size_t i = 0; i < 24; ++i) {
+            panel.pcbSerials[i] = fields[i + 1];
+        }
+        panel.status = PanelStatus::Detected;
+        panel.sourceFile = csvPath;
+        outPanels.push_back(panel);
+    }
+    return true;
+}
+
+// Memory held by the same panels as std::vector<Panel> and as a PackedPanelStore,
+// both grown one panel at a time as the search index does and reserved up front
+struct MemoryResult {
+    std::string name;
+    long long panels;
+    size_t panelBytes;
+    size_t packedBytes;
+    size_t packedReservedBytes;
+};
+
+// Heap blocks a Panel holds beyond its own size: one for every string too
+// long for the small-string buffer
+static size_t panelHeapBytes(const Panel& panel) {
+    const size_t inlineCapacity = std::string().capacity();
+    auto heap = [inlineCapacity](const std::string& s) { return s.capacity() > inlineCapacity ? s.capacity() + 1 : 0; };
+    size_t bytes = heap(panel.panelID) + heap(panel.panelNumber) + heap(panel.createdAt) +
+                   heap(panel.laseredAt) + heap(panel.sourceFile) + heap(panel.operatorName);
+    for (const std::string& serial : panel.pcbSerials) {
+        bytes += heap(serial);
+    }
+    return bytes;
+}
+
+static MemoryResult measurePanelMemory(const std::string& name, const std::string& serialPrefix, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Panel> panels;
+    panels.reserve(MEMORY_PANELS);
+    size_t heapBytes = 0;
+    size_t textBytes = 0;
+    for (int i = 0; i < MEMORY_PANELS; ++i) {
+        panels.push_back(syntheticPanel(i, serialPrefix, rng));
+        panels.back().createdAt = currentTimestamp();
+        heapBytes += panelHeapBytes(panels.back());
+        textBytes += panels.back().panelID.size() + panels.back().panelNumber.size();
+        for (const std::string& serial : panels.back().pcbSerials) {
+            textBytes += serial.size();
+        }
+    }
+
+    PackedPanelStore grown;
+    PackedPanelStore reserved;
+    reserved.reserve(panels.size(), textBytes);
+    for (const Panel& panel : panels) {
+        grown.add(panel);
+        reserved.add(panel);
+    }
+    return MemoryResult{name, MEMORY_PANELS, panels.capacity() * sizeof(Panel) + heapBytes, grown.memoryUsed(),
+                        reserved.memoryUsed()};
+}
+
+static std::string memoryToJson(const std::vector<MemoryResult>& results) {
+    std::ostringstream out;
+    out << "[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const MemoryResult& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name << "\", \"panels\": " << r.panels
+            << ", \"panel_bytes\": " << r.panelBytes << ", \"packed_bytes\": " << r.packedBytes
+            << ", \"packed_reserved_bytes\": " << r.packedReservedBytes << "}";
+    }
+    out << "\n  ]";
+    return out.str();
+}
+
+static void printMemory(const std::vector<MemoryResult>& results) {
+    std::printf("memory (bytes per panel)\n");
+    for (const MemoryResult& r : results) {
+        double panels = static_cast<double>(r.panels);
+        std::printf("  %-22s %8lld x  Panel %6.0f  packed %6.0f (%4.1fx)  reserved %6.0f (%4.1fx)\n", r.name.c_str(),
+                    r.panels, r.panelBytes / panels, r.packedBytes / panels,
+                    static_cast<double>(r.panelBytes) / static_cast<double>(r.packedBytes),
+                    r.packedReservedBytes / panels,
+                    static_cast<double>(r.panelBytes) / static_cast<double>(r.packedReservedBytes));
+    }
+    std::fflush(stdout);
+}
+
+// Benchmarks that do not depend on the ledger: input parsing and building
+// artwork in memory
+static std::vector<BenchResult> runFixedBenchmarks(const std::string& workDir, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Panel> panels;
+    for (int i = 0; i < (std::max)(PARSE_CSV_ROWS, SVG_BATCH_PANELS); ++i) {
+        panels.push_back(syntheticPanel(i, "FX", rng));
+        panels.back().createdAt = currentTimestamp();
+    }
+    std::string csvPath = (fs::path(workDir) / "parse_input.csv").string();
+    writeInputCsv(csvPath, std::vector<Panel>(panels.begin(), panels.begin() + PARSE_CSV_ROWS));
+
+    std::vector<BenchResult> results;
+    results.push_back(timeEach("parse_csv_legacy", 5, [&](long long) {
+        std::vector<Panel> parsed;
+        legacyParsePanelsCsv(csvPath, parsed);
+    }));
+    results.push_back(timeEach("parse_csv_reader", 5, [&](long long) {
+        std::vector<Panel> parsed;
+        parsePanelsCsvFile(csvPath, parsed);
+    }));
+
+    SvgWriter svg;
+    results.push_back(timeEach("build_art_svg", SVG_BATCH_PANELS, [&](long long i) {
+        buildPanelArtSvg(panels[static_cast<size_t>(i)], "bench", svg);
+    }));
+    results.push_back(timeEach("build_datamatrix_svg", SVG_BATCH_PANELS, [&](long long i) {
+        buildPanelDataMatrixSvg(panels[static_cast<size_t>(i)], "bench", svg);
+    }));
+
+    std::error_code ec;
+    fs::remove(csvPath, ec);
+    return results;
+}
+
+// One ledger size, run inside a child copy whose folder holds nothing else
+static int runChild(long long rows, long long iterations, uint64_t seed) {
+    if (!fs::exists(appDataPath(CHILD_MARKER))) {
+        std::fprintf(stderr, "--child only runs in a folder prepared by the benchmark driver\n");
+        return 2;
+    }
+    g_currentOperator = "bench";
+
+    std::vector<BenchResult> results;
+    bool generated = false;
+    results.push_back(timeEach("generate_ledger", 1, [&](long long) {
+        generated = generateLedger(rows, seed);
+    }));
+    if (!generated) {
+        std::fprintf(stderr, "could not generate a %lld row ledger\n", rows);
+        return 1;
+    }
+
+    // One single-panel input file per iteration, numbered after the ledger
+    std::mt19937_64 rng(seed + 1);
+    std::string inputDir = appDataPath(WolfTrackConfig::INPUT_PANELS_ROOT);
+    fs::create_directories(inputDir);
+    std::vector<std::string> inputFiles;
+    std::vector<Panel> freshPanels;
+    for (long long i = 0; i < iterations; ++i) {
+        std::string path = (fs::path(inputDir) / ("bench_" + std::to_string(i) + ".csv")).string();
+        writeInputCsv(path, {syntheticPanel(rows + i, "IN", rng)});
+        inputFiles.push_back(path);
+        freshPanels.push_back(syntheticPanel(rows + iterations + i, "AP", rng));
+    }
+
+    results.push_back(timeEach("open_ledger", 1, [](long long) { ensureMasterJournalExists(); }));
+    results.push_back(timeEach("ledger_index_cold", 1, [](long long) { generateNextPanelID(); }));
+    results.push_back(timeEach("next_panel_id", iterations, [](long long) { generateNextPanelID(); }));
+    results.push_back(timeEach("compute_stats", iterations, [](long long) { computeMasterStats(); }));
+    results.push_back(timeEach("serial_index_cold", 1, [&](long long) { findDuplicateSerials({freshPanels[0]}); }));
+
+    long long failures = 0;
+    results.push_back(timeEach("load_panel_csv", iterations, [&](long long i) {
+        Panel loaded;
+        PanelLoadReport report;
+        if (!loadPanelFromCsvFile(inputFiles[static_cast<size_t>(i)], loaded, report)) {
+            failures++;
+        }
+    }));
+    results.push_back(timeEach("append_panel", iterations, [&](long long i) {
+        if (appendPanelToMaster(freshPanels[static_cast<size_t>(i)]) != LedgerError::None) {
+            failures++;
+        }
+    }));
+    results.push_back(timeEach("panel_art_svg", iterations, [&](long long i) {
+        if (createPanelArtSvg(freshPanels[static_cast<size_t>(i)]).empty()) {
+            failures++;
+        }
+    }));
+    results.push_back(timeEach("datamatrix_svg", iterations, [&](long long i) {
+        if (createPanelDataMatrixSvg(freshPanels[static_cast<size_t>(i)]).empty()) {
+            failures++;
+        }
+    }));
+    results.push_back(timeEach("export_master_csv", 1, [&](long long) {
+        if (!exportMasterCsv()) {
+            failures++;
+        }
+    }));
+
+    printResults("rows=" + std::to_string(rows), results);
+
+    std::ofstream out(appDataPath("result.json"), std::ios::out | std::ios::trunc);
+    out << "{\"rows\": " << rows << ", \"failures\": " << failures
+        << ", \"results\": " << resultsToJson(results, "      ") << "}";
+    if (failures > 0) {
+        std::fprintf(stderr, "rows=%lld: %lld operation(s) failed\n", rows, failures);
+    }
+    return (out && failures == 0) ? 0 : 1;
+}
+
+// Copy this program into its own folder and run one ledger size there
+static bool runSize(const fs::path& workDir, long long rows, long long iterations, uint64_t seed,
+                    bool keep, std::string& json) {
+    fs::path dir = workDir / ("rows_" + std::to_string(rows));
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+    fs::path self(executablePath());
+    fs::path child = dir / self.filename();
+    fs::copy_file(self, child, fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+        return false;
+    }
+    std::ofstream(dir / CHILD_MARKER) << "MasterDataBench work folder\n";
+
+    std::string command = "\"" + child.string() + "\" --child " + std::to_string(rows) +
+                          " --iterations " + std::to_string(iterations) + " --seed " + std::to_string(seed);
+#ifdef _WIN32
+    command = "\"" + command + "\"";  // cmd.exe strips the outer pair
+#endif
+    int status = std::system(command.c_str());
+
+    std::ifstream in(dir / "result.json");
+    std::stringstream result;
+    result << in.rdbuf();
+    in.close();
+    json = result.str();
+    if (!keep) {
+        fs::remove_all(dir, ec);
+    }
+    return status == 0 && !json.empty();
+}
+
+static int usage() {
+    std::fprintf(stderr, "usage: MasterDataBench [--rows N,N,...] [--iterations N] [--seed N] "
+                         "[--work DIR] [--out FILE] [--keep]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    std::string started = currentTimestamp();
+    std::vector<long long> sizes = {1000, 10000, 100000};
+    long long iterations = 200;
+    uint64_t seed = 1;
+    fs::path workDir = fs::temp_directory_path() / "wolftrack_bench";
+    std::string outPath = "bench_results.json";
+    bool keep = false;
+    long long childRows = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rows" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                sizes.push_back(std::strtoll(item.c_str(), nullptr, 10));
+            }
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::strtoll(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--work" && i + 1 < argc) {
+            workDir = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--keep") {
+            keep = true;
+        } else if (arg == "--child" && i + 1 < argc) {
+            childRows = std::strtoll(argv[++i], nullptr, 10);
+        } else {
+            return usage();
+        }
+    }
+    if (iterations < 1 || sizes.empty()) {
+        return usage();
+    }
+    if (childRows >= 0) {
+        return runChild(childRows, iterations, seed);
+    }
+    for (long long rows : sizes) {
+        if (rows < 1 || rows > 10000000) {
+            std::fprintf(stderr, "ledger sizes run from 1 to 10000000 rows\n");
+            return 2;
+        }
+    }
+
+    fs::create_directories(workDir);
+    std::vector<BenchResult> fixed = runFixedBenchmarks(workDir.string(), seed);
+    printResults("fixed", fixed);
+
+    // Serials that fit the small-string buffer, then ones long enough to need a heap block each
+    std::vector<MemoryResult> memory = {measurePanelMemory("panels_short_serials", "FX", seed),
+                                        measurePanelMemory("panels_long_serials", "FX-LONG-SERIAL-", seed)};
+    printMemory(memory);
+
+    std::vector<std::string> runs;
+    bool ok = true;
+    for (long long rows : sizes) {
+        std::string json;
+        if (!runSize(workDir, rows, iterations, seed, keep, json)) {
+            std::fprintf(stderr, "rows=%lld failed\n", rows);
+            ok = false;
+        }
+        if (!json.empty()) {
+            runs.push_back(json);
+        }
+    }
+
+    std::ofstream out(outPath, std::ios::out | std::ios::trunc);
+    out << "{\n  \"benchmark\": \"MasterDataBench\",\n  \"started\": \"" << started << "\",\n"
+#ifdef _WIN32
+        << "  \"platform\": \"windows\",\n"
+#else
+        << "  \"platform\": \"linux\",\n"
+#endif
+        << "  \"seed\": " << seed << ",\n  \"iterations\": " << iterations << ",\n"
+        << "  \"fixed\": " << resultsToJson(fixed, "  ") << ",\n  \"memory\": " << memoryToJson(memory)
+        << ",\n  \"runs\": [";
+    for (size_t i = 0; i < runs.size(); ++i) {
+        out << (i == 0 ? "\n    " : ",\n    ") << runs[i];
+    }
+    out << "\n  ]\n}\n";
+    std::printf("results written to %s\n", outPath.c_str());
+    return (ok && out) ? 0 : 1;
+}
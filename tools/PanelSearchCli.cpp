@@ -0,0 +1,60 @@
+// Headless front-end for the ledger search API, e.g.
+//   PanelSearchCli ABC00            PanelIDs or serials starting with ABC00
+//   PanelSearchCli --substring 0042 PanelIDs or serials containing 0042
+// Reads the ledger next to the executable, like the main application.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "MasterData.h"
+
+static long long millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int usage() {
+    std::fprintf(stderr, "usage: PanelSearchCli [--prefix | --substring] [--limit N] <query>\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    PanelSearchMode mode = PanelSearchMode::Prefix;
+    size_t limit = 100;
+    std::string query;
+    bool haveQuery = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--prefix") {
+            mode = PanelSearchMode::Prefix;
+        } else if (arg == "--substring") {
+            mode = PanelSearchMode::Substring;
+        } else if (arg == "--limit" && i + 1 < argc) {
+            limit = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!haveQuery && (arg.empty() || arg[0] != '-')) {
+            query = arg;
+            haveQuery = true;
+        } else {
+            return usage();
+        }
+    }
+    if (!haveQuery) {
+        return usage();
+    }
+
+    // Load the index up front so the query time below is the search alone
+    auto start = std::chrono::steady_clock::now();
+    searchMasterPanels("", PanelSearchMode::Prefix, 0);
+    long long loadMs = millisSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<PanelSearchResult> results = searchMasterPanels(query, mode, limit);
+    long long queryMs = millisSince(start);
+
+    for (const PanelSearchResult& result : results) {
+        std::string field = result.slot == 0 ? "PanelID" : "PCB" + std::to_string(result.slot);
+        std::printf("%-12s %-8s %-24s %-20s %s\n", result.panel.panelID.c_str(), field.c_str(),
+                    result.matched.c_str(), result.panel.createdAt.c_str(), result.panel.operatorName.c_str());
+    }
+    std::printf("%zu match(es); index loaded in %lld ms, query took %lld ms\n", results.size(), loadMs, queryMs);
+    return results.empty() ? 1 : 0;
+}
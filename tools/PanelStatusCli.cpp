@@ -0,0 +1,73 @@
+// Headless front-end for the panel status log, e.g.
+//   PanelStatusCli WT-P-00123                   Current status of one panel
+//   PanelStatusCli --list ReadyForLaser         Every panel waiting for the laser
+//   PanelStatusCli --set WT-P-00123 Lasered     Move a panel forward
+// Uses the ledger next to the executable and the operator saved in settings.ini.
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "AppPaths.h"
+#include "MasterData.h"
+#include "SessionState.h"
+
+static int usage() {
+    std::fprintf(stderr, "usage: PanelStatusCli <PanelID>\n"
+                         "       PanelStatusCli --list <LabelPrinted|ReadyForLaser|Lasered>\n"
+                         "       PanelStatusCli --set <PanelID> <LabelPrinted|ReadyForLaser|Lasered>\n");
+    return 2;
+}
+
+// Status text as typed; panelStatusFromString() maps anything unknown to Detected
+static bool parseStatus(const std::string& text, PanelStatus& out) {
+    out = panelStatusFromString(text);
+    return out != PanelStatus::Detected || text == "Detected";
+}
+
+static std::string savedOperator() {
+    std::ifstream file(appPaths().settingsFile);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find("operator=") == 0) {
+            return line.substr(9);
+        }
+    }
+    return "";
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    PanelStatus status = PanelStatus::Detected;
+
+    if (args.size() == 2 && args[0] == "--list") {
+        if (!parseStatus(args[1], status) || status == PanelStatus::Detected) {
+            return usage();
+        }
+        std::vector<std::string> ids = panelsWithStatus(status);
+        for (const std::string& id : ids) {
+            std::printf("%s\n", id.c_str());
+        }
+        std::printf("%zu panel(s) %s\n", ids.size(), panelStatusToString(status).c_str());
+        return 0;
+    }
+
+    if (args.size() == 3 && args[0] == "--set") {
+        if (!parseStatus(args[2], status)) {
+            return usage();
+        }
+        g_currentOperator = savedOperator();
+        StatusChangeError error = setPanelStatus(args[1], status);
+        if (error != StatusChangeError::None) {
+            std::fprintf(stderr, "%s: %s\n", args[1].c_str(), statusChangeErrorToString(error).c_str());
+            return 1;
+        }
+        std::printf("%s %s\n", args[1].c_str(), panelStatusToString(status).c_str());
+        return 0;
+    }
+
+    if (args.size() == 1 && !args[0].empty() && args[0][0] != '-') {
+        std::printf("%s %s\n", args[0].c_str(), panelStatusToString(currentPanelStatus(args[0])).c_str());
+        return 0;
+    }
+    return usage();
+}